@@ -31,6 +31,7 @@
 #include <realm/impl/output_stream.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/bptree.hpp>
+#include <realm/index_range.hpp>
 #include <realm/index_string.hpp>
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/exceptions.hpp>
@@ -647,6 +648,16 @@ public:
             return true;
     }
 
+    // Range index for equal(), greater(), less() and between() conditions. It
+    // lives only in this accessor (see RangeIndex), and get_range_index()
+    // hands out a mutable pointer because the index is refreshed lazily by the
+    // queries that use it.
+    using RangeIndexType = RangeIndex<typename util::RemoveOptional<T>::type>;
+    bool has_range_index() const noexcept;
+    void add_range_index();
+    void remove_range_index() noexcept;
+    RangeIndexType* get_range_index() const noexcept;
+
 
     //@{
     /// Find the lower/upper bound for the specified value assuming
@@ -761,6 +772,7 @@ private:
     friend class StringIndex;
 
     BpTree<T> m_tree;
+    std::unique_ptr<RangeIndexType> m_range_index;
 
     void do_erase(size_t row_ndx, size_t num_rows_to_erase, bool is_last);
 };
@@ -1014,22 +1026,42 @@ StringData Column<T>::get_index_data(size_t ndx, StringIndex::StringConversionBu
     return to_str(x, buffer);
 }
 
+template <class T>
+bool Column<T>::has_range_index() const noexcept
+{
+    return bool(m_range_index);
+}
+
+template <class T>
+void Column<T>::add_range_index()
+{
+    if (!m_range_index)
+        m_range_index.reset(new RangeIndexType); // Throws
+}
+
+template <class T>
+void Column<T>::remove_range_index() noexcept
+{
+    m_range_index.reset();
+}
+
+template <class T>
+typename Column<T>::RangeIndexType* Column<T>::get_range_index() const noexcept
+{
+    return m_range_index.get();
+}
+
 template <class T>
 void Column<T>::populate_search_index()
 {
     REALM_ASSERT(has_search_index());
     // Populate the index
     size_t num_rows = size();
-    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx) {
-        bool is_append = true;
-        if (is_null(row_ndx)) {
-            m_search_index->insert(row_ndx, null{}, 1, is_append); // Throws
-        }
-        else {
-            T value = get(row_ndx);
-            m_search_index->insert(row_ndx, value, 1, is_append); // Throws
-        }
-    }
+    std::vector<T> values;
+    values.reserve(num_rows);
+    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx)
+        values.push_back(get(row_ndx)); // Null is represented by T
+    m_search_index->insert_bulk(values); // Throws
 }
 
 template <class T>
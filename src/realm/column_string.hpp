@@ -25,6 +25,7 @@
 #include <realm/array_blobs_big.hpp>
 #include <realm/column.hpp>
 #include <realm/column_tpl.hpp>
+#include <realm/index_ngram.hpp>
 
 namespace realm {
 
@@ -102,10 +103,18 @@ public:
     }
     StringIndex* create_search_index() override;
 
-    // Simply inserts all column values in the index in a loop
+    // Indexes all column values with StringIndex::insert_bulk()
     void populate_search_index();
     void destroy_search_index() noexcept override;
 
+    // N-gram index for substring conditions. It lives only in this accessor
+    // (see NGramIndex), and get_ngram_index() hands out a mutable pointer
+    // because the index is refreshed lazily by the queries that use it.
+    bool has_ngram_index() const noexcept;
+    void add_ngram_index();
+    void remove_ngram_index() noexcept;
+    NGramIndex* get_ngram_index() const noexcept;
+
     // Optimizing data layout. enforce == true will enforce enumeration;
     // enforce == false will auto-evaluate if it should be enumerated or not
     bool auto_enumerate(ref_type& keys, ref_type& values, bool enforce = false) const;
@@ -143,6 +152,7 @@ public:
 
 private:
     std::unique_ptr<StringIndex> m_search_index;
+    std::unique_ptr<NGramIndex> m_ngram_index;
     bool m_nullable;
 
     LeafType get_block(size_t ndx, ArrayParent**, size_t& off, bool use_retval = false) const;
@@ -297,6 +307,27 @@ inline bool StringColumn::has_search_index() const noexcept
     return m_search_index != 0;
 }
 
+inline bool StringColumn::has_ngram_index() const noexcept
+{
+    return bool(m_ngram_index);
+}
+
+inline void StringColumn::add_ngram_index()
+{
+    if (!m_ngram_index)
+        m_ngram_index.reset(new NGramIndex); // Throws
+}
+
+inline void StringColumn::remove_ngram_index() noexcept
+{
+    m_ngram_index.reset();
+}
+
+inline NGramIndex* StringColumn::get_ngram_index() const noexcept
+{
+    return m_ngram_index.get();
+}
+
 inline StringIndex* StringColumn::get_search_index() noexcept
 {
     return m_search_index.get();
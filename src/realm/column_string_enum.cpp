@@ -319,19 +319,23 @@ StringIndex* StringEnumColumn::create_search_index()
     std::unique_ptr<StringIndex> index;
     index.reset(new StringIndex(this, get_alloc())); // Throws
 
-    // Populate the index
-    size_t num_rows = size();
-    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx) {
-        StringData value = get(row_ndx);
-        size_t num_rows_to_insert = 1;
-        bool is_append = true;
-        index->insert(row_ndx, value, num_rows_to_insert, is_append); // Throws
-    }
-
     m_search_index = std::move(index);
+    populate_search_index(); // Throws
     return m_search_index.get();
 }
 
+void StringEnumColumn::populate_search_index()
+{
+    REALM_ASSERT(m_search_index);
+
+    size_t num_rows = size();
+    std::vector<StringData> values;
+    values.reserve(num_rows);
+    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx)
+        values.push_back(get(row_ndx));
+    m_search_index->insert_bulk(values); // Throws
+}
+
 void StringEnumColumn::destroy_search_index() noexcept
 {
     m_search_index.reset();
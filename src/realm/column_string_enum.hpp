@@ -117,6 +117,8 @@ public:
         return true;
     }
     StringIndex* create_search_index() override;
+    // Indexes all column values with StringIndex::insert_bulk()
+    void populate_search_index();
     void install_search_index(std::unique_ptr<StringIndex>) noexcept;
     void destroy_search_index() noexcept override;
 
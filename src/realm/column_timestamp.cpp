@@ -256,11 +256,11 @@ void TimestampColumn::populate_search_index()
     REALM_ASSERT(has_search_index());
     // Populate the index
     size_t num_rows = size();
-    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx) {
-        bool is_append = true;
-        auto value = get(row_ndx);
-        m_search_index->insert(row_ndx, value, 1, is_append); // Throws
-    }
+    std::vector<Timestamp> values;
+    values.reserve(num_rows);
+    for (size_t row_ndx = 0; row_ndx != num_rows; ++row_ndx)
+        values.push_back(get(row_ndx));
+    m_search_index->insert_bulk(values); // Throws
 }
 
 StringIndex* TimestampColumn::create_search_index()
@@ -74,6 +74,26 @@ public:
     }
 
     StringData get_index_data(size_t, StringIndex::StringConversionBuffer& buffer) const noexcept override;
+
+    // Range index for equal(), greater(), less() and between() conditions, see
+    // Column<T>::get_range_index()
+    bool has_range_index() const noexcept
+    {
+        return bool(m_range_index);
+    }
+    void add_range_index()
+    {
+        if (!m_range_index)
+            m_range_index.reset(new RangeIndex<Timestamp>); // Throws
+    }
+    void remove_range_index() noexcept
+    {
+        m_range_index.reset();
+    }
+    RangeIndex<Timestamp>* get_range_index() const noexcept
+    {
+        return m_range_index.get();
+    }
     ref_type write(size_t slice_offset, size_t slice_size, size_t table_size, _impl::OutputStream&) const override;
     void update_from_parent(size_t old_baseline) noexcept override;
     void set_ndx_in_parent(size_t ndx) noexcept override;
@@ -117,6 +137,7 @@ private:
     std::unique_ptr<BpTree<int64_t>> m_nanoseconds;
 
     std::unique_ptr<StringIndex> m_search_index;
+    std::unique_ptr<RangeIndex<Timestamp>> m_range_index;
     bool m_nullable;
 
     template <class BT>
@@ -31,6 +31,7 @@
 #include <realm/impl/output_stream.hpp>
 #include <realm/impl/cont_transact_hist.hpp>
 #include <realm/metrics/metrics.hpp>
+#include <realm/query_cache.hpp>
 #include <realm/table.hpp>
 #include <realm/alloc_slab.hpp>
 
@@ -603,6 +604,7 @@ private:
     std::function<void(const CascadeNotification&)> m_notify_handler;
     std::function<void()> m_schema_change_handler;
     std::shared_ptr<metrics::Metrics> m_metrics;
+    std::shared_ptr<QueryCache> m_query_cache;
     size_t m_total_rows;
 
     struct shared_tag {
@@ -698,6 +700,9 @@ private:
     void set_replication(Replication*) noexcept;
     std::shared_ptr<metrics::Metrics> get_metrics() const noexcept;
     void set_metrics(std::shared_ptr<metrics::Metrics> other) noexcept;
+    // Null unless a SharedGroup with query caching enabled is in a read transaction
+    QueryCache* get_query_cache() const noexcept;
+    void set_query_cache(std::shared_ptr<QueryCache> cache) noexcept;
     void update_num_objects();
     class TransactAdvancer;
     void advance_transact(ref_type new_top_ref, size_t new_file_size, _impl::NoCopyInputStream&);
@@ -792,6 +797,7 @@ private:
     void prepare_history_parent(Array& history_root, int history_type, int history_schema_version);
 
     friend class Table;
+    friend class Query;
     friend class GroupWriter;
     friend class SharedGroup;
     friend class _impl::GroupFriend;
@@ -1170,6 +1176,16 @@ inline void Group::set_metrics(std::shared_ptr<metrics::Metrics> shared) noexcep
     m_metrics = shared;
 }
 
+inline QueryCache* Group::get_query_cache() const noexcept
+{
+    return m_query_cache.get();
+}
+
+inline void Group::set_query_cache(std::shared_ptr<QueryCache> cache) noexcept
+{
+    m_query_cache = std::move(cache);
+}
+
 // The purpose of this class is to give internal access to some, but
 // not all of the non-public parts of the Group class.
 class _impl::GroupFriend {
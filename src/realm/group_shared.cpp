@@ -777,6 +777,8 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
         m_group.set_metrics(m_metrics);
     }
 #endif // REALM_METRICS
+    if (options.enable_query_cache)
+        m_query_cache = std::make_shared<QueryCache>();
 
     Replication::HistoryType openers_hist_type = Replication::hist_None;
     int openers_hist_schema_version = 0;
@@ -1503,6 +1505,12 @@ void SharedGroup::set_transact_stage(SharedGroup::TransactStage stage) noexcept
     }
 #endif
 
+    if (m_query_cache) {
+        // Results are only cached for the duration of a read transaction
+        m_query_cache->clear();
+        m_group.set_query_cache(stage == transact_Reading ? m_query_cache : nullptr);
+    }
+
     m_transact_stage = stage;
 }
 
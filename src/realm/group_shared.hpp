@@ -592,6 +592,7 @@ private:
 #if REALM_METRICS
     std::shared_ptr<metrics::Metrics> m_metrics;
 #endif // REALM_METRICS
+    std::shared_ptr<QueryCache> m_query_cache;
 
     void do_open(const std::string& file, bool no_create, bool is_backend, const SharedGroupOptions options);
 
@@ -1087,6 +1088,9 @@ inline bool SharedGroup::do_advance_read(O* observer, VersionID version_id, _imp
     // part of the Realm state, then it would not have been necessary to retain
     // the old read lock beyond this point.
 
+    if (m_query_cache)
+        m_query_cache->clear(); // Results of the old snapshot
+
     {
         version_type old_version = m_read_lock.m_version;
         version_type new_version = new_read_lock.m_version;
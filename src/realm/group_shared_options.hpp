@@ -38,13 +38,14 @@ struct SharedGroupOptions {
                                 bool allow_upgrade = true,
                                 std::function<void(int, int)> file_upgrade_callback = std::function<void(int, int)>(),
                                 std::string temp_directory = sys_tmp_dir,
-                                bool track_metrics = false)
+                                bool track_metrics = false, bool cache_queries = false)
         : durability(level)
         , encryption_key(key)
         , allow_file_format_upgrade(allow_upgrade)
         , upgrade_callback(file_upgrade_callback)
         , temp_dir(temp_directory)
         , enable_metrics(track_metrics)
+        , enable_query_cache(cache_queries)
 
     {
     }
@@ -56,6 +57,7 @@ struct SharedGroupOptions {
         , upgrade_callback(std::function<void(int, int)>())
         , temp_dir(sys_tmp_dir)
         , enable_metrics(false)
+        , enable_query_cache(false)
     {
     }
 
@@ -95,6 +97,15 @@ struct SharedGroupOptions {
     /// A prerequisite is compiling with REALM_METRICS=ON.
     bool enable_metrics;
 
+    /// Controls whether the results of Query::count(), Query::sum_int() and
+    /// Query::find_all() are cached for the duration of a read transaction,
+    /// so that repeating an identical query on the same snapshot is answered
+    /// without evaluating it again. The cache is emptied whenever the
+    /// SharedGroup moves to another snapshot, and is not used in write
+    /// transactions. Hits and misses are counted in the metrics if those are
+    /// enabled. A prerequisite is compiling with REALM_METRICS=ON.
+    bool enable_query_cache;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating SharedGroupOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
@@ -0,0 +1,190 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_ROW_BITMAP_HPP
+#define REALM_IMPL_ROW_BITMAP_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <realm/util/assert.hpp>
+#include <realm/utilities.hpp>
+
+namespace realm {
+
+/// A bitmap of table rows in the range [begin(), end()), used as intermediate
+/// result when a query is evaluated one condition at a time instead of one
+/// row at a time. Bit `i` represents row `begin() + i`.
+///
+/// The bitmap is deliberately uncompressed. It only ever covers one chunk of
+/// bitmap_chunk_size rows (1 KiB of words), so a compressed encoding would
+/// save little memory, and it would turn set(), intersect() and count() into
+/// run decoding instead of plain word operations.
+class RowBitmap {
+public:
+    RowBitmap(size_t begin, size_t end)
+    {
+        reset(begin, end);
+    }
+
+    /// Rebind the bitmap to a new row range and clear all bits.
+    void reset(size_t begin, size_t end)
+    {
+        REALM_ASSERT_DEBUG(begin <= end);
+        m_begin = begin;
+        m_end = end;
+        m_words.assign((end - begin + 63) / 64, 0);
+    }
+
+    size_t begin() const noexcept
+    {
+        return m_begin;
+    }
+
+    size_t end() const noexcept
+    {
+        return m_end;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_end - m_begin;
+    }
+
+    bool get(size_t row) const noexcept
+    {
+        size_t i = row - m_begin;
+        return (m_words[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(size_t row) noexcept
+    {
+        size_t i = row - m_begin;
+        m_words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    void unset(size_t row) noexcept
+    {
+        size_t i = row - m_begin;
+        m_words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+    void set_all() noexcept
+    {
+        for (auto& w : m_words)
+            w = ~uint64_t(0);
+        clear_padding();
+    }
+
+    void invert() noexcept
+    {
+        for (auto& w : m_words)
+            w = ~w;
+        clear_padding();
+    }
+
+    void intersect(const RowBitmap& other) noexcept
+    {
+        REALM_ASSERT_DEBUG(other.m_begin == m_begin && other.m_end == m_end);
+        for (size_t i = 0; i < m_words.size(); ++i)
+            m_words[i] &= other.m_words[i];
+    }
+
+    void unite(const RowBitmap& other) noexcept
+    {
+        REALM_ASSERT_DEBUG(other.m_begin == m_begin && other.m_end == m_end);
+        for (size_t i = 0; i < m_words.size(); ++i)
+            m_words[i] |= other.m_words[i];
+    }
+
+    bool none() const noexcept
+    {
+        for (auto w : m_words) {
+            if (w)
+                return false;
+        }
+        return true;
+    }
+
+    size_t count() const noexcept
+    {
+        size_t n = 0;
+        for (auto w : m_words)
+            n += fast_popcount64(int64_t(w));
+        return n;
+    }
+
+    /// Returns the first set row at or after \a row, or end() if there is none.
+    size_t find_next(size_t row) const noexcept
+    {
+        if (row >= m_end)
+            return m_end;
+        size_t i = row - m_begin;
+        size_t w = i >> 6;
+        uint64_t bits = m_words[w] & (~uint64_t(0) << (i & 63));
+        while (!bits) {
+            if (++w == m_words.size())
+                return m_end;
+            bits = m_words[w];
+        }
+        return m_begin + (w << 6) + bit_index(bits & (~bits + 1));
+    }
+
+    /// Call \a func for every set row in ascending order. Stops early and
+    /// returns false if \a func returns false.
+    template <class F>
+    bool for_each(F func) const
+    {
+        for (size_t w = 0; w < m_words.size(); ++w) {
+            uint64_t bits = m_words[w];
+            while (bits) {
+                uint64_t lowest = bits & (~bits + 1);
+                if (!func(m_begin + (w << 6) + bit_index(lowest)))
+                    return false;
+                bits ^= lowest;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    size_t m_begin;
+    size_t m_end;
+
+    // Index of the only set bit in \a bit. Split in halves so that it also
+    // works where size_t is 32 bits wide.
+    static size_t bit_index(uint64_t bit) noexcept
+    {
+        uint32_t low = uint32_t(bit);
+        if (low)
+            return size_t(log2(low));
+        return 32 + size_t(log2(uint32_t(bit >> 32)));
+    }
+
+    void clear_padding() noexcept
+    {
+        size_t tail = size() & 63;
+        if (tail)
+            m_words.back() &= (uint64_t(1) << tail) - 1;
+    }
+};
+
+} // namespace realm
+
+#endif // REALM_IMPL_ROW_BITMAP_HPP
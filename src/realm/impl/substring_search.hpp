@@ -0,0 +1,87 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_SUBSTRING_SEARCH_HPP
+#define REALM_IMPL_SUBSTRING_SEARCH_HPP
+
+#include <cstddef>
+
+#include <realm/util/features.h>
+#include <realm/utilities.hpp>
+
+#ifdef REALM_COMPILER_SSE
+#include <emmintrin.h> // SSE2
+#endif
+
+namespace realm {
+namespace _impl {
+
+/// Returns the position of the first occurrence of a needle of \a needle_size
+/// (> 0) bytes in the \a size bytes at \a data, or \a size if there is none.
+///
+/// A position is a candidate if its first byte is \a first_a or \a first_b
+/// and the byte at `needle_size - 1` past it is \a last_a or \a last_b (the
+/// pairs are equal for case sensitive search). With SSE2, 16 consecutive
+/// positions are filtered at a time by comparing against broadcast copies of
+/// these bytes, which skips almost all of the haystack without branching.
+/// `verify(p)` decides whether a candidate at `p` really is a match.
+template <class Verify>
+size_t search_first_last(const char* data, size_t size, size_t needle_size, char first_a, char first_b, char last_a,
+                         char last_b, Verify verify) noexcept
+{
+    REALM_ASSERT_DEBUG(needle_size > 0);
+    if (needle_size > size)
+        return size;
+
+    size_t num_positions = size - needle_size + 1;
+    size_t last_offset = needle_size - 1;
+    size_t i = 0;
+
+#ifdef REALM_COMPILER_SSE
+    const __m128i fa = _mm_set1_epi8(first_a);
+    const __m128i fb = _mm_set1_epi8(first_b);
+    const __m128i la = _mm_set1_epi8(last_a);
+    const __m128i lb = _mm_set1_epi8(last_b);
+    for (; i + 16 <= num_positions; i += 16) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + last_offset));
+        __m128i eq_first = _mm_or_si128(_mm_cmpeq_epi8(first, fa), _mm_cmpeq_epi8(first, fb));
+        __m128i eq_last = _mm_or_si128(_mm_cmpeq_epi8(last, la), _mm_cmpeq_epi8(last, lb));
+        unsigned mask = unsigned(_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last)));
+        while (mask) {
+            size_t pos = i + size_t(log2(mask & (~mask + 1)));
+            if (verify(data + pos))
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < num_positions; ++i) {
+        char first = data[i];
+        char last = data[i + last_offset];
+        if ((first == first_a || first == first_b) && (last == last_a || last == last_b) && verify(data + i))
+            return i;
+    }
+    return size;
+}
+
+} // namespace _impl
+} // namespace realm
+
+#endif // REALM_IMPL_SUBSTRING_SEARCH_HPP
@@ -0,0 +1,209 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+
+#include <realm/index_composite.hpp>
+#include <realm/table.hpp>
+
+using namespace realm;
+
+namespace {
+
+// Null sorts before every value of the column
+const char null_tag = 0;
+const char value_tag = 1;
+
+void append_big_endian(std::string& key, uint64_t value, int num_bytes)
+{
+    for (int i = num_bytes - 1; i >= 0; --i)
+        key += char(uint8_t(value >> (8 * i)));
+}
+
+} // anonymous namespace
+
+CompositeIndex::CompositeIndex(std::vector<size_t> columns)
+    : m_columns(std::move(columns))
+{
+}
+
+void CompositeIndex::append_null(std::string& key)
+{
+    key += null_tag;
+}
+
+void CompositeIndex::append_int(std::string& key, int64_t value)
+{
+    // Flipping the sign bit makes the unsigned, big endian representation sort like the signed value
+    key += value_tag;
+    append_big_endian(key, uint64_t(value) ^ (uint64_t(1) << 63), 8);
+}
+
+void CompositeIndex::append_string(std::string& key, StringData value)
+{
+    if (value.is_null()) {
+        append_null(key);
+        return;
+    }
+    // Zero bytes are escaped so that the terminator cannot occur inside a string, which keeps the keys of the
+    // following columns from being mistaken for part of this one
+    key += value_tag;
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        key += c;
+        if (c == 0)
+            key += char(0xFF);
+    }
+    key += char(0);
+    key += char(0);
+}
+
+void CompositeIndex::append_timestamp(std::string& key, Timestamp value)
+{
+    if (value.is_null()) {
+        append_null(key);
+        return;
+    }
+    append_int(key, value.get_seconds());
+    append_big_endian(key, uint32_t(value.get_nanoseconds()) ^ (uint32_t(1) << 31), 4);
+}
+
+void CompositeIndex::refresh(const Table& table, uint_fast64_t version)
+{
+    if (m_built && m_version == version)
+        return;
+
+    m_entries.clear();
+    m_built = false;
+
+    size_t size = table.size();
+    m_entries.resize(size);
+    for (size_t row = 0; row < size; ++row)
+        m_entries[row].second = row;
+
+    for (size_t col_ndx : m_columns) {
+        DataType type = table.get_column_type(col_ndx);
+        bool nullable = table.is_nullable(col_ndx);
+        for (size_t row = 0; row < size; ++row) {
+            std::string& key = m_entries[row].first;
+            if (nullable && table.is_null(col_ndx, row)) {
+                append_null(key);
+                continue;
+            }
+            switch (type) {
+                case type_Int:
+                    append_int(key, table.get_int(col_ndx, row));
+                    break;
+                case type_Bool:
+                    append_int(key, table.get_bool(col_ndx, row));
+                    break;
+                case type_String:
+                    append_string(key, table.get_string(col_ndx, row));
+                    break;
+                case type_Timestamp:
+                    append_timestamp(key, table.get_timestamp(col_ndx, row));
+                    break;
+                default:
+                    REALM_UNREACHABLE();
+            }
+        }
+    }
+    std::sort(m_entries.begin(), m_entries.end());
+
+    m_version = version;
+    m_built = true;
+}
+
+CompositeIndex::Iterator CompositeIndex::begin_of(const std::string& prefix) const
+{
+    return std::lower_bound(m_entries.begin(), m_entries.end(), prefix,
+                            [](const Entry& a, const std::string& b) { return a.first < b; });
+}
+
+CompositeIndex::Iterator CompositeIndex::end_of(const std::string& prefix) const
+{
+    // The first entry that neither starts with the prefix nor sorts before it
+    return std::upper_bound(m_entries.begin(), m_entries.end(), prefix, [](const std::string& a, const Entry& b) {
+        return b.first.compare(0, a.size(), a) > 0;
+    });
+}
+
+void CompositeIndex::find_rows(const std::string& prefix, Bound lower, const std::string& lower_key, Bound upper,
+                               const std::string& upper_key, std::vector<size_t>& rows) const
+{
+    REALM_ASSERT(m_built);
+    rows.clear();
+
+    Iterator begin, end;
+    if (lower == Bound::inclusive)
+        begin = begin_of(prefix + lower_key);
+    else if (lower == Bound::exclusive)
+        begin = end_of(prefix + lower_key);
+    else if (upper != Bound::unbounded)
+        begin = begin_of(prefix + value_tag); // Skip the nulls
+    else
+        begin = begin_of(prefix);
+
+    if (upper == Bound::inclusive)
+        end = end_of(prefix + upper_key);
+    else if (upper == Bound::exclusive)
+        end = begin_of(prefix + upper_key);
+    else
+        end = end_of(prefix);
+
+    if (begin >= end)
+        return;
+    rows.reserve(end - begin);
+    for (Iterator it = begin; it != end; ++it)
+        rows.push_back(it->second);
+    std::sort(rows.begin(), rows.end());
+}
+
+void CompositeIndex::adj_insert_column(size_t col_ndx) noexcept
+{
+    for (size_t& c : m_columns) {
+        if (c >= col_ndx)
+            ++c;
+    }
+    m_built = false;
+}
+
+bool CompositeIndex::adj_erase_column(size_t col_ndx) noexcept
+{
+    if (std::find(m_columns.begin(), m_columns.end(), col_ndx) != m_columns.end())
+        return false;
+    for (size_t& c : m_columns) {
+        if (c > col_ndx)
+            --c;
+    }
+    m_built = false;
+    return true;
+}
+
+void CompositeIndex::adj_move_column(size_t from, size_t to) noexcept
+{
+    for (size_t& c : m_columns) {
+        if (c == from)
+            c = to;
+        else if (from < to && c > from && c <= to)
+            --c;
+        else if (to < from && c >= to && c < from)
+            ++c;
+    }
+    m_built = false;
+}
@@ -0,0 +1,104 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_COMPOSITE_HPP
+#define REALM_INDEX_COMPOSITE_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <realm/string_data.hpp>
+#include <realm/timestamp.hpp>
+
+namespace realm {
+
+class Table;
+
+/// An index over an ordered list of columns of a table, which keeps its rows
+/// sorted by the values of the first column, then of the second, and so on. A
+/// query that compares each of the first N columns for equality, and the
+/// column after them (if any) against a lower and/or an upper bound, finds
+/// all its matches in one contiguous range of the index.
+///
+/// The values of a row are encoded into a single key which sorts like the
+/// tuple of the values: nulls first, integers and Timestamps in numerical
+/// order. Strings are only ordered by their bytes, which is enough for
+/// equality. Int, bool, string and Timestamp columns can be indexed.
+///
+/// The index is not stored in the Realm file. It is owned by the table
+/// accessor (see Table::add_composite_index()) and rebuilt on the first query
+/// after the table has changed, as indicated by Table::get_version_counter().
+class CompositeIndex {
+public:
+    enum class Bound { unbounded, inclusive, exclusive };
+
+    explicit CompositeIndex(std::vector<size_t> columns);
+
+    const std::vector<size_t>& get_columns() const noexcept;
+
+    /// Make the index reflect the contents of \a table at the specified
+    /// version. Does nothing if it already does.
+    void refresh(const Table& table, uint_fast64_t version);
+
+    /// Store in \a rows, in ascending order, every row whose key starts with
+    /// \a prefix, the concatenated keys of the values that the leading
+    /// columns must be equal to. If \a lower or \a upper is not
+    /// Bound::unbounded, the value of the column after those must also be
+    /// greater than (or equal to) \a lower_key, or less than (or equal to)
+    /// \a upper_key, which must then be non-null keys.
+    void find_rows(const std::string& prefix, Bound lower, const std::string& lower_key, Bound upper,
+                   const std::string& upper_key, std::vector<size_t>& rows) const;
+
+    /// Append the key of a value to \a key.
+    static void append_null(std::string& key);
+    static void append_int(std::string& key, int64_t value);
+    static void append_string(std::string& key, StringData value);
+    static void append_timestamp(std::string& key, Timestamp value);
+
+    // Keep the column indexes in step with the columns of the table. Returns
+    // false if the index covers the erased column and must be dropped.
+    void adj_insert_column(size_t col_ndx) noexcept;
+    bool adj_erase_column(size_t col_ndx) noexcept;
+    void adj_move_column(size_t from, size_t to) noexcept;
+
+private:
+    using Entry = std::pair<std::string, size_t>;
+    using Iterator = std::vector<Entry>::const_iterator;
+
+    std::vector<size_t> m_columns;
+    std::vector<Entry> m_entries; // Sorted by key, then by row
+    uint_fast64_t m_version = 0;
+    bool m_built = false;
+
+    Iterator begin_of(const std::string& prefix) const;
+    Iterator end_of(const std::string& prefix) const;
+};
+
+
+// Implementation:
+
+inline const std::vector<size_t>& CompositeIndex::get_columns() const noexcept
+{
+    return m_columns;
+}
+
+} // namespace realm
+
+#endif // REALM_INDEX_COMPOSITE_HPP
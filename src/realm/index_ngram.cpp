@@ -0,0 +1,157 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+
+#include <realm/index_ngram.hpp>
+#include <realm/array_blobs_big.hpp>
+#include <realm/array_string.hpp>
+#include <realm/array_string_long.hpp>
+#include <realm/column_string.hpp>
+
+using namespace realm;
+
+namespace {
+
+inline char fold(char c) noexcept
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+inline bool is_ascii(char c) noexcept
+{
+    return (c & 0x80) == 0;
+}
+
+} // anonymous namespace
+
+void NGramIndex::add_grams(StringData str, bool case_insensitive, std::vector<Gram>& grams)
+{
+    if (str.size() < gram_size)
+        return;
+    const char* p = str.data();
+    for (size_t i = 0; i + gram_size <= str.size(); ++i) {
+        // Case insensitive matching compares non-ASCII characters in all their encodings, which the byte-wise
+        // folding of the keys does not capture, so such trigrams cannot be used for filtering
+        if (case_insensitive && !(is_ascii(p[i]) && is_ascii(p[i + 1]) && is_ascii(p[i + 2])))
+            continue;
+        grams.push_back(Gram(uint8_t(fold(p[i]))) | Gram(uint8_t(fold(p[i + 1]))) << 8 |
+                        Gram(uint8_t(fold(p[i + 2]))) << 16);
+    }
+}
+
+void NGramIndex::refresh(const StringColumn& column, uint_fast64_t version)
+{
+    if (m_built && m_version == version)
+        return;
+
+    m_postings.clear();
+    m_built = false;
+
+    std::vector<Gram> grams;
+    size_t size = column.size();
+    size_t row = 0;
+    while (row < size) {
+        size_t ndx_in_leaf;
+        StringColumn::LeafType leaf_type;
+        std::unique_ptr<const ArrayParent> leaf = column.get_leaf(row, ndx_in_leaf, leaf_type);
+        size_t leaf_start = row - ndx_in_leaf;
+        size_t leaf_size;
+        if (leaf_type == StringColumn::leaf_type_Small)
+            leaf_size = static_cast<const ArrayString&>(*leaf).size();
+        else if (leaf_type == StringColumn::leaf_type_Medium)
+            leaf_size = static_cast<const ArrayStringLong&>(*leaf).size();
+        else
+            leaf_size = static_cast<const ArrayBigBlobs&>(*leaf).size();
+
+        for (size_t i = ndx_in_leaf; i < leaf_size; ++i) {
+            StringData str;
+            if (leaf_type == StringColumn::leaf_type_Small)
+                str = static_cast<const ArrayString&>(*leaf).get(i);
+            else if (leaf_type == StringColumn::leaf_type_Medium)
+                str = static_cast<const ArrayStringLong&>(*leaf).get(i);
+            else
+                str = static_cast<const ArrayBigBlobs&>(*leaf).get_string(i);
+
+            grams.clear();
+            add_grams(str, false, grams);
+            std::sort(grams.begin(), grams.end());
+            grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+            // Rows are visited in ascending order, so every posting list stays sorted
+            for (Gram gram : grams)
+                m_postings[gram].push_back(leaf_start + i);
+        }
+        row = leaf_start + leaf_size;
+    }
+
+    m_version = version;
+    m_built = true;
+}
+
+bool NGramIndex::intersect(std::vector<Gram>& grams, std::vector<size_t>& rows) const
+{
+    rows.clear();
+    if (grams.empty())
+        return false;
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    std::vector<const std::vector<size_t>*> lists;
+    lists.reserve(grams.size());
+    for (Gram gram : grams) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end())
+            return true; // No row has this trigram, so none can match
+        lists.push_back(&it->second);
+    }
+
+    // Start from the shortest list, which bounds the size of the result
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<size_t>* a, const std::vector<size_t>* b) { return a->size() < b->size(); });
+    rows = *lists[0];
+    std::vector<size_t> tmp;
+    for (size_t i = 1; i < lists.size() && !rows.empty(); ++i) {
+        tmp.clear();
+        std::set_intersection(rows.begin(), rows.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(tmp));
+        rows.swap(tmp);
+    }
+    return true;
+}
+
+bool NGramIndex::find_candidates(StringData needle, bool case_insensitive, std::vector<size_t>& rows) const
+{
+    REALM_ASSERT(m_built);
+    std::vector<Gram> grams;
+    add_grams(needle, case_insensitive, grams);
+    return intersect(grams, rows);
+}
+
+bool NGramIndex::find_like_candidates(StringData pattern, bool case_insensitive, std::vector<size_t>& rows) const
+{
+    REALM_ASSERT(m_built);
+    std::vector<Gram> grams;
+    size_t run_start = 0;
+    for (size_t i = 0; i <= pattern.size(); ++i) {
+        if (i == pattern.size() || pattern[i] == '*' || pattern[i] == '?') {
+            add_grams(pattern.substr(run_start, i - run_start), case_insensitive, grams);
+            run_start = i + 1;
+        }
+    }
+    return intersect(grams, rows);
+}
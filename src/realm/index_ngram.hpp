@@ -0,0 +1,76 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_NGRAM_HPP
+#define REALM_INDEX_NGRAM_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <realm/string_data.hpp>
+
+namespace realm {
+
+class StringColumn;
+
+/// An inverted index from the trigrams (3-byte substrings) of the values of a
+/// string column to the rows containing them. It answers which rows *may*
+/// contain a given substring, so that contains(), begins_with(), ends_with()
+/// and like() conditions only have to test those rows instead of all of them.
+///
+/// Trigrams are keyed with ASCII letters folded to lower case, so the same
+/// index serves case sensitive and case insensitive conditions. Either way the
+/// candidates are a superset of the matches and must be verified.
+///
+/// The index is not stored in the Realm file. It is owned by the column
+/// accessor (see Table::add_ngram_index()) and rebuilt from the column on the
+/// first query after the table has changed, as indicated by
+/// Table::get_version_counter().
+class NGramIndex {
+public:
+    static const size_t gram_size = 3;
+
+    /// Make the index reflect the contents of \a column at the specified
+    /// table version. Does nothing if it already does.
+    void refresh(const StringColumn& column, uint_fast64_t version);
+
+    /// Store in \a rows, in ascending order, every row that may contain \a
+    /// needle as a substring. Returns false, leaving \a rows empty, if the
+    /// needle has no trigram that the index can filter on, in which case
+    /// every row is a candidate.
+    bool find_candidates(StringData needle, bool case_insensitive, std::vector<size_t>& rows) const;
+
+    /// Same as find_candidates() for a like() pattern: every row that may
+    /// contain all literal runs between the wildcards of \a pattern.
+    bool find_like_candidates(StringData pattern, bool case_insensitive, std::vector<size_t>& rows) const;
+
+private:
+    using Gram = uint32_t;
+
+    std::unordered_map<Gram, std::vector<size_t>> m_postings;
+    uint_fast64_t m_version = 0;
+    bool m_built = false;
+
+    static void add_grams(StringData str, bool case_insensitive, std::vector<Gram>& grams);
+    bool intersect(std::vector<Gram>& grams, std::vector<size_t>& rows) const;
+};
+
+} // namespace realm
+
+#endif // REALM_INDEX_NGRAM_HPP
@@ -0,0 +1,223 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_RANGE_HPP
+#define REALM_INDEX_RANGE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <realm/query_conditions.hpp>
+#include <realm/timestamp.hpp>
+#include <realm/util/assert.hpp>
+#include <realm/util/optional.hpp>
+
+namespace realm {
+
+/// An index of the values of an integer, Timestamp, float or double column in
+/// ascending order, which answers which rows satisfy an equal(), greater(),
+/// less(), or similar condition (and so between()) by binary search rather
+/// than by a scan of the column. The search index cannot do that, because its
+/// keys do not sort in numerical order, and it does not support floating point
+/// columns at all.
+///
+/// Null values are left out, since they never satisfy these conditions. So
+/// are NaNs, which compare unequal to everything, and -0.0 is indexed as 0.0,
+/// to which it compares equal. This leaves a set of keys that `operator<`
+/// orders totally.
+///
+/// The index is not stored in the Realm file. It is owned by the column
+/// accessor (see Table::add_range_index()) and rebuilt from the column on the
+/// first query after the table has changed, as indicated by
+/// Table::get_version_counter().
+template <class T>
+class RangeIndex {
+public:
+    /// Make the index reflect the contents of \a column at the specified
+    /// table version. Does nothing if it already does.
+    template <class ColType>
+    void refresh(const ColType& column, uint_fast64_t version);
+
+    /// Store in \a rows, in ascending order, every row whose value `v`
+    /// satisfies `Cond()(v, value)`, where Cond is one of Equal, Greater,
+    /// GreaterEqual, Less and LessEqual. Returns false, leaving \a rows
+    /// empty, if there would be more than \a max_rows of them, in which case
+    /// scanning the column is expected to be cheaper.
+    template <class Cond>
+    bool find_rows(const T& value, size_t max_rows, std::vector<size_t>& rows) const;
+
+    /// Returns the rank of every row of the column in the order of the
+    /// values: rows with equal values have equal ranks, a smaller value has a
+    /// smaller rank, and the rows that are not indexed (null and NaN) have
+    /// rank 0. All ranks are less than \a num_ranks. This lets a view be
+    /// sorted, or made distinct, on the column in linear time (see
+    /// RowIndexes::do_sort()). The ranks are computed on the first call after
+    /// the index has been rebuilt.
+    const std::vector<size_t>& get_ranks(size_t& num_ranks) const;
+
+    /// Store in \a key the key under which \a value is indexed. Returns false
+    /// for null, which is not indexed.
+    static bool get_key(int64_t value, int64_t& key)
+    {
+        key = value;
+        return true;
+    }
+    static bool get_key(const util::Optional<int64_t>& value, int64_t& key)
+    {
+        if (!value)
+            return false;
+        key = *value;
+        return true;
+    }
+    static bool get_key(Timestamp value, Timestamp& key)
+    {
+        key = value;
+        return !value.is_null();
+    }
+    static bool get_key(float value, float& key)
+    {
+        return get_float_key(value, key);
+    }
+    static bool get_key(double value, double& key)
+    {
+        return get_float_key(value, key);
+    }
+
+private:
+    using Entry = std::pair<T, size_t>;
+    using Iterator = typename std::vector<Entry>::const_iterator;
+
+    std::vector<Entry> m_entries; // Sorted by value, then by row
+    size_t m_num_rows = 0;        // Size of the column, including the rows left out
+    uint_fast64_t m_version = 0;
+    bool m_built = false;
+    mutable std::vector<size_t> m_ranks; // Empty until requested
+    mutable size_t m_num_ranks = 1;
+
+    template <class F>
+    static bool get_float_key(F value, F& key)
+    {
+        // Null is a NaN too
+        if (value != value)
+            return false;
+        key = (value == 0 ? F(0) : value);
+        return true;
+    }
+
+    Iterator lower(const T& value) const
+    {
+        return std::lower_bound(m_entries.begin(), m_entries.end(), value,
+                                [](const Entry& a, const T& b) { return a.first < b; });
+    }
+    Iterator upper(const T& value) const
+    {
+        return std::upper_bound(m_entries.begin(), m_entries.end(), value,
+                                [](const T& a, const Entry& b) { return a < b.first; });
+    }
+
+    std::pair<Iterator, Iterator> range(Equal, const T& value) const
+    {
+        return {lower(value), upper(value)};
+    }
+    std::pair<Iterator, Iterator> range(Greater, const T& value) const
+    {
+        return {upper(value), m_entries.end()};
+    }
+    std::pair<Iterator, Iterator> range(GreaterEqual, const T& value) const
+    {
+        return {lower(value), m_entries.end()};
+    }
+    std::pair<Iterator, Iterator> range(Less, const T& value) const
+    {
+        return {m_entries.begin(), lower(value)};
+    }
+    std::pair<Iterator, Iterator> range(LessEqual, const T& value) const
+    {
+        return {m_entries.begin(), upper(value)};
+    }
+};
+
+
+// Implementation:
+
+template <class T>
+template <class ColType>
+void RangeIndex<T>::refresh(const ColType& column, uint_fast64_t version)
+{
+    if (m_built && m_version == version)
+        return;
+
+    m_entries.clear();
+    m_ranks.clear();
+    m_num_ranks = 1;
+    m_built = false;
+
+    size_t size = column.size();
+    m_entries.reserve(size);
+    for (size_t row = 0; row < size; ++row) {
+        T key;
+        if (get_key(column.get(row), key))
+            m_entries.emplace_back(key, row);
+    }
+    std::sort(m_entries.begin(), m_entries.end());
+
+    m_num_rows = size;
+    m_version = version;
+    m_built = true;
+}
+
+template <class T>
+template <class Cond>
+bool RangeIndex<T>::find_rows(const T& value, size_t max_rows, std::vector<size_t>& rows) const
+{
+    REALM_ASSERT(m_built);
+    rows.clear();
+    std::pair<Iterator, Iterator> found = range(Cond(), value);
+    if (size_t(found.second - found.first) > max_rows)
+        return false;
+
+    rows.reserve(found.second - found.first);
+    for (Iterator it = found.first; it != found.second; ++it)
+        rows.push_back(it->second);
+    std::sort(rows.begin(), rows.end());
+    return true;
+}
+
+template <class T>
+const std::vector<size_t>& RangeIndex<T>::get_ranks(size_t& num_ranks) const
+{
+    REALM_ASSERT(m_built);
+    if (m_ranks.size() != m_num_rows) {
+        m_ranks.assign(m_num_rows, 0); // Throws
+        size_t rank = 0;
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (i == 0 || m_entries[i - 1].first < m_entries[i].first)
+                ++rank;
+            m_ranks[m_entries[i].second] = rank;
+        }
+        m_num_ranks = rank + 1;
+    }
+    num_ranks = m_num_ranks;
+    return m_ranks;
+}
+
+} // namespace realm
+
+#endif // REALM_INDEX_RANGE_HPP
@@ -16,8 +16,10 @@
  *
  **************************************************************************/
 
+#include <algorithm>
 #include <cstdio>
 #include <iomanip>
+#include <numeric>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -745,6 +747,107 @@ void StringIndex::insert_row_list(size_t ref, size_t offset, StringData value)
 }
 
 
+void StringIndex::insert_bulk(const std::vector<StringData>& values)
+{
+    REALM_ASSERT(is_empty());
+    if (values.empty())
+        return;
+
+    std::vector<size_t> rows(values.size());
+    std::iota(rows.begin(), rows.end(), size_t(0));
+    ref_type ref = build_bulk(values.data(), rows, 0); // Throws
+
+    m_array->destroy_deep();
+    m_array->init_from_ref(ref);
+    m_array->update_parent();
+}
+
+
+ref_type StringIndex::build_bulk(const StringData* values, const std::vector<size_t>& rows, size_t offset)
+{
+    Allocator& alloc = m_array->get_alloc();
+
+    // Ties are broken by row, so the rows of each key come out in ascending order
+    std::vector<std::pair<key_type, size_t>> entries;
+    entries.reserve(rows.size());
+    for (size_t row : rows)
+        entries.emplace_back(create_key(values[row], offset), row);
+    std::sort(entries.begin(), entries.end());
+
+    // One slot per distinct key, laid out like leaf_insert() would have left it
+    std::vector<key_type> keys;
+    std::vector<int64_t> slots;
+    std::vector<size_t> group;
+    size_t suboffset = offset + s_index_key_length;
+    for (size_t i = 0; i < entries.size();) {
+        key_type key = entries[i].first;
+        group.clear();
+        for (; i < entries.size() && entries[i].first == key; ++i)
+            group.push_back(entries[i].second);
+
+        int64_t slot;
+        if (group.size() == 1) {
+            slot = int64_t((uint64_t(group[0]) << 1) + 1); // shift to indicate literal
+        }
+        else {
+            StringData first = values[group[0]];
+            bool only_duplicates =
+                std::all_of(group.begin() + 1, group.end(), [&](size_t row) { return values[row] == first; });
+            if (only_duplicates || suboffset > s_max_offset) {
+                // Lists are sorted by value, and by row within each value
+                if (!only_duplicates) {
+                    std::stable_sort(group.begin(), group.end(),
+                                     [&](size_t a, size_t b) { return values[a] < values[b]; });
+                }
+                ref_type list_ref = IntegerColumn::create(alloc); // Throws
+                IntegerColumn list(alloc, list_ref);               // Throws
+                for (size_t row : group)
+                    list.add(row);              // Throws
+                slot = int64_t(list.get_ref()); // The root changes when the list outgrows a leaf
+            }
+            else {
+                slot = int64_t(build_bulk(values, group, suboffset)); // Throws
+            }
+        }
+        keys.push_back(key);
+        slots.push_back(slot);
+    }
+
+    return build_nodes(std::move(keys), std::move(slots)); // Throws
+}
+
+
+ref_type StringIndex::build_nodes(std::vector<key_type> keys, std::vector<int64_t> slots)
+{
+    REALM_ASSERT(!slots.empty());
+    Allocator& alloc = m_array->get_alloc();
+
+    // Pack the slots into leaves, then the leaves into inner nodes keyed by
+    // their last key, and so on until a single root remains
+    bool is_leaf = true;
+    while (is_leaf || slots.size() > 1) {
+        std::vector<key_type> parent_keys;
+        std::vector<int64_t> parent_slots;
+        for (size_t begin = 0; begin < slots.size(); begin += REALM_MAX_BPNODE_SIZE) {
+            size_t end = std::min(begin + REALM_MAX_BPNODE_SIZE, slots.size());
+            std::unique_ptr<IndexArray> node(create_node(alloc, is_leaf)); // Throws
+            Array node_keys(alloc);
+            get_child(*node, 0, node_keys);
+            for (size_t i = begin; i < end; ++i) {
+                node_keys.add(keys[i]); // Throws
+                node->add(slots[i]);    // Throws
+            }
+            parent_keys.push_back(keys[end - 1]);
+            parent_slots.push_back(int64_t(node->get_ref()));
+        }
+        keys.swap(parent_keys);
+        slots.swap(parent_slots);
+        is_leaf = false;
+    }
+    return to_ref(slots[0]);
+}
+
+
 void StringIndex::TreeInsert(size_t row_ndx, key_type key, size_t offset, StringData value)
 {
     NodeChange nc = do_insert(row_ndx, key, offset, value);
@@ -22,6 +22,7 @@
 #include <cstring>
 #include <memory>
 #include <array>
+#include <vector>
 
 #include <realm/array.hpp>
 #include <realm/column_fwd.hpp>
@@ -135,6 +136,14 @@ public:
     template <class T>
     void insert(size_t row_ndx, util::Optional<T> value, size_t num_rows, bool is_append);
 
+    /// Index every row of the target column at once, where `values[i]` is the
+    /// value of row `i`. The index must be empty. Instead of descending the
+    /// tree once per row, the (key, row) pairs of each level are sorted and
+    /// the nodes are built bottom-up, filled to REALM_MAX_BPNODE_SIZE.
+    template <class T>
+    void insert_bulk(const std::vector<T>& values);
+    void insert_bulk(const std::vector<StringData>& values);
+
     template <class T>
     void set(size_t row_ndx, T new_value);
     template <class T>
@@ -255,6 +264,10 @@ private:
 
     void node_add_key(ref_type ref);
 
+    // Bulk build: the subtree indexing \a rows (ascending) from \a offset
+    ref_type build_bulk(const StringData* values, const std::vector<size_t>& rows, size_t offset);
+    ref_type build_nodes(std::vector<key_type> keys, std::vector<int64_t> slots);
+
 #ifdef REALM_DEBUG
     static void dump_node_structure(const Array& node, std::ostream&, int level);
     static void array_to_dot(std::ostream&, const Array&);
@@ -464,6 +477,18 @@ void StringIndex::insert(size_t row_ndx, util::Optional<T> value, size_t num_row
     }
 }
 
+template <class T>
+void StringIndex::insert_bulk(const std::vector<T>& values)
+{
+    // The conversion of non-string values needs storage for each of them
+    std::vector<StringConversionBuffer> buffers(values.size());
+    std::vector<StringData> strings;
+    strings.reserve(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        strings.push_back(to_str(T(values[i]), buffers[i]));
+    insert_bulk(strings); // Throws
+}
+
 template <class T>
 void StringIndex::set(size_t row_ndx, T new_value)
 {
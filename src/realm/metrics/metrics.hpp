@@ -44,6 +44,11 @@ public:
     void add_query(QueryInfo info);
     void add_transaction(TransactionInfo info);
 
+    // Lookups in the query result cache (see SharedGroupOptions::enable_query_cache)
+    void add_query_cache_lookup(bool hit) noexcept;
+    size_t num_query_cache_hits() const noexcept;
+    size_t num_query_cache_misses() const noexcept;
+
     void start_read_transaction();
     void start_write_transaction();
     void end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions);
@@ -63,6 +68,9 @@ private:
 
     std::unique_ptr<TransactionInfo> m_pending_read;
     std::unique_ptr<TransactionInfo> m_pending_write;
+
+    size_t m_query_cache_hits = 0;
+    size_t m_query_cache_misses = 0;
 };
 
 
@@ -28,6 +28,7 @@
 #include <realm/table_view.hpp>
 
 #include <algorithm>
+#include <sstream>
 
 
 using namespace realm;
@@ -766,6 +767,45 @@ Query& Query::less(size_t column_ndx, Timestamp value)
     return add_condition<Less>(column_ndx, value);
 }
 
+// ------------- membership
+Query& Query::in(size_t column_ndx, const std::vector<int64_t>& values)
+{
+    REALM_ASSERT_DEBUG(m_current_descriptor);
+    std::unique_ptr<ParentNode> node;
+    switch (m_current_descriptor->get_column_type(column_ndx)) {
+        case type_Int:
+        case type_Bool:
+        case type_OldDateTime:
+            if (m_current_descriptor->is_nullable(column_ndx))
+                node.reset(new IntegerInNode<IntNullColumn>(values, column_ndx));
+            else
+                node.reset(new IntegerInNode<IntegerColumn>(values, column_ndx));
+            break;
+        default:
+            throw LogicError{LogicError::type_mismatch};
+    }
+    add_node(std::move(node));
+    return *this;
+}
+
+Query& Query::in(size_t column_ndx, const std::vector<StringData>& values)
+{
+    REALM_ASSERT_DEBUG(m_current_descriptor);
+    if (m_current_descriptor->get_column_type(column_ndx) != type_String)
+        throw LogicError{LogicError::type_mismatch};
+    add_node(std::unique_ptr<ParentNode>(new StringInNode(values, column_ndx)));
+    return *this;
+}
+
+Query& Query::in(size_t column_ndx, const std::vector<Timestamp>& values)
+{
+    REALM_ASSERT_DEBUG(m_current_descriptor);
+    if (m_current_descriptor->get_column_type(column_ndx) != type_Timestamp)
+        throw LogicError{LogicError::type_mismatch};
+    add_node(std::unique_ptr<ParentNode>(new TimestampInNode(values, column_ndx)));
+    return *this;
+}
+
 // ------------- size
 Query& Query::size_equal(size_t column_ndx, int64_t value)
 {
@@ -990,10 +1030,31 @@ int64_t Query::sum_int(size_t column_ndx, size_t* resultcount, size_t start, siz
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Sum);
 #endif
 
+    std::string cache_key;
+    QueryCache* cache = get_query_cache(cache_key, "sum_int", column_ndx, start, end, limit);
+    if (cache) {
+        if (const QueryCache::Result* cached = find_cached(*cache, cache_key)) {
+            if (resultcount)
+                *resultcount = cached->result_count;
+            return cached->value;
+        }
+    }
+
+    QueryCache::Result result;
     if (m_table->is_nullable(column_ndx)) {
-        return aggregate<act_Sum, int64_t>(&IntNullColumn::sum, column_ndx, resultcount, start, end, limit);
+        result.value =
+            aggregate<act_Sum, int64_t>(&IntNullColumn::sum, column_ndx, &result.result_count, start, end, limit);
     }
-    return aggregate<act_Sum, int64_t>(&IntegerColumn::sum, column_ndx, resultcount, start, end, limit);
+    else {
+        result.value =
+            aggregate<act_Sum, int64_t>(&IntegerColumn::sum, column_ndx, &result.result_count, start, end, limit);
+    }
+    if (resultcount)
+        *resultcount = result.result_count;
+    int64_t sum = result.value;
+    if (cache)
+        cache->insert(cache_key, std::move(result));
+    return sum;
 }
 double Query::sum_float(size_t column_ndx, size_t* resultcount, size_t start, size_t end, size_t limit) const
 {
@@ -1323,6 +1384,31 @@ size_t Query::find(size_t begin)
 }
 
 void Query::find_all(TableViewBase& ret, size_t begin, size_t end, size_t limit) const
+{
+    std::string cache_key;
+    QueryCache* cache = get_query_cache(cache_key, "find_all", npos, begin, end, limit);
+    if (!cache) {
+        do_find_all(ret, begin, end, limit);
+        return;
+    }
+
+    IntegerColumn& refs = ret.m_row_indexes;
+    if (const QueryCache::Result* cached = find_cached(*cache, cache_key)) {
+        for (size_t row : cached->rows)
+            refs.add(row);
+        return;
+    }
+
+    size_t old_size = refs.size();
+    do_find_all(ret, begin, end, limit);
+    QueryCache::Result result;
+    result.rows.reserve(refs.size() - old_size);
+    for (size_t i = old_size; i < refs.size(); ++i)
+        result.rows.push_back(to_size_t(refs.get(i)));
+    cache->insert(cache_key, std::move(result));
+}
+
+void Query::do_find_all(TableViewBase& ret, size_t begin, size_t end, size_t limit) const
 {
     if (limit == 0 || m_table->is_degenerate())
         return;
@@ -1349,6 +1435,13 @@ void Query::find_all(TableViewBase& ret, size_t begin, size_t end, size_t limit)
                 refs.add(i);
             }
         }
+        else if (use_bitmap_evaluation()) {
+            IntegerColumn& refs = ret.m_row_indexes;
+            find_all_bitmap(begin, end, [&](size_t row) {
+                refs.add(row);
+                return refs.size() < limit;
+            });
+        }
         else {
             QueryState<int64_t> st;
             st.init(act_FindAll, &ret.m_row_indexes, limit);
@@ -1376,6 +1469,23 @@ size_t Query::count(size_t start, size_t end, size_t limit) const
     std::unique_ptr<MetricTimer> metric_timer = QueryInfo::track(this, QueryInfo::type_Count);
 #endif
 
+    std::string cache_key;
+    QueryCache* cache = get_query_cache(cache_key, "count", npos, start, end, limit);
+    if (!cache)
+        return do_count(start, end, limit);
+
+    if (const QueryCache::Result* cached = find_cached(*cache, cache_key))
+        return size_t(cached->value);
+
+    QueryCache::Result result;
+    result.value = int64_t(do_count(start, end, limit));
+    size_t cnt = size_t(result.value);
+    cache->insert(cache_key, std::move(result));
+    return cnt;
+}
+
+size_t Query::do_count(size_t start, size_t end, size_t limit) const
+{
     if (limit == 0 || m_table->is_degenerate())
         return 0;
 
@@ -1403,6 +1513,9 @@ size_t Query::count(size_t start, size_t end, size_t limit) const
             }
         }
     }
+    else if (use_bitmap_evaluation()) {
+        cnt = count_bitmap(start, end, limit);
+    }
     else {
         QueryState<int64_t> st;
         st.init(act_Count, nullptr, limit);
@@ -1578,16 +1691,98 @@ std::string Query::get_description() const
     return "";
 }
 
+QueryCache* Query::get_query_cache(std::string& key, const char* operation, size_t column_ndx, size_t start,
+                                   size_t end, size_t limit) const
+{
+#if REALM_METRICS
+    // Only group level tables can be part of a SharedGroup
+    Group* group = m_table && m_table->is_attached() ? m_table->get_parent_group() : nullptr;
+    QueryCache* cache = group ? group->get_query_cache() : nullptr;
+    if (!cache || m_view || !error_code.empty() || m_groups.size() != 1)
+        return nullptr;
+    if (ParentNode* root = root_node()) {
+        if (!root->describe_expression_is_exact())
+            return nullptr;
+    }
+
+    std::ostringstream out;
+    out << operation << ' ' << m_table->get_index_in_group() << ' ' << m_table->get_version_counter() << ' '
+        << column_ndx << ' ' << start << ' ' << end << ' ' << limit << ' ' << get_description();
+    key = out.str();
+    return cache;
+#else
+    // Without metrics the values of the conditions are not part of the
+    // description, so it cannot identify the query
+    static_cast<void>(key);
+    static_cast<void>(operation);
+    static_cast<void>(column_ndx);
+    static_cast<void>(start);
+    static_cast<void>(end);
+    static_cast<void>(limit);
+    return nullptr;
+#endif
+}
+
+const QueryCache::Result* Query::find_cached(QueryCache& cache, const std::string& key) const
+{
+    const QueryCache::Result* result = cache.find(key);
+#if REALM_METRICS
+    if (std::shared_ptr<metrics::Metrics> group_metrics = m_table->get_parent_group()->get_metrics())
+        group_metrics->add_query_cache_lookup(result != nullptr);
+#endif
+    return result;
+}
+
 void Query::init() const
 {
     REALM_ASSERT(m_table);
     if (ParentNode* root = root_node()) {
         root->init();
+        root->init_composite_index();
         std::vector<ParentNode*> v;
         root->gather_children(v);
     }
 }
 
+bool Query::use_bitmap_evaluation() const
+{
+    ParentNode* root = root_node();
+    return std::any_of(root->m_children.begin(), root->m_children.end(),
+                       [](const ParentNode* node) { return node->prefers_bitmap_evaluation(); });
+}
+
+// Evaluates the query over [start, end) in chunks of bitmap_chunk_size rows and calls func(row) for every match in
+// ascending order until it returns false.
+template <class F>
+void Query::find_all_bitmap(size_t start, size_t end, F func) const
+{
+    ParentNode* root = root_node();
+    RowBitmap matches(start, start);
+    for (size_t chunk_start = start; chunk_start < end; chunk_start += bitmap_chunk_size) {
+        size_t chunk_end = std::min(end, chunk_start + bitmap_chunk_size);
+        matches.reset(chunk_start, chunk_end);
+        root->find_all_bitmap(matches);
+        if (!matches.for_each(func))
+            return;
+    }
+}
+
+// Like find_all_bitmap(), but only counts the matches of each chunk. Individual rows are never visited: once a
+// chunk holds more matches than the remaining limit, the limit is the result.
+size_t Query::count_bitmap(size_t start, size_t end, size_t limit) const
+{
+    ParentNode* root = root_node();
+    RowBitmap matches(start, start);
+    size_t cnt = 0;
+    for (size_t chunk_start = start; chunk_start < end && cnt < limit; chunk_start += bitmap_chunk_size) {
+        size_t chunk_end = std::min(end, chunk_start + bitmap_chunk_size);
+        matches.reset(chunk_start, chunk_end);
+        root->find_all_bitmap(matches);
+        cnt += std::min(matches.count(), limit - cnt);
+    }
+    return cnt;
+}
+
 size_t Query::find_internal(size_t start, size_t end) const
 {
     if (end == size_t(-1))
@@ -42,6 +42,7 @@
 #include <realm/link_view_fwd.hpp>
 #include <realm/descriptor_fwd.hpp>
 #include <realm/row.hpp>
+#include <realm/query_cache.hpp>
 
 namespace realm {
 
@@ -238,6 +239,13 @@ public:
     Query& ends_with(size_t column_ndx, BinaryData value);
     Query& contains(size_t column_ndx, BinaryData value);
 
+    // Conditions: membership. Matches rows whose value equals any of the given
+    // values, like a group of equal() conditions joined by Or(). An empty list
+    // matches no rows. Integer values apply to int, bool and date columns.
+    Query& in(size_t column_ndx, const std::vector<int64_t>& values);
+    Query& in(size_t column_ndx, const std::vector<StringData>& values);
+    Query& in(size_t column_ndx, const std::vector<Timestamp>& values);
+
     // Negation
     Query& Not();
 
@@ -419,8 +427,23 @@ private:
                             size_t start, size_t end, SequentialGetterBase* source_column) const;
 
     void find_all(TableViewBase& tv, size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1)) const;
+    void do_find_all(TableViewBase& tv, size_t start, size_t end, size_t limit) const;
+    size_t do_count(size_t start, size_t end, size_t limit) const;
     void delete_nodes() noexcept;
 
+    // Returns the cache of the Group if the result of \a operation may be
+    // cached, in which case \a key is set to the key to cache it under.
+    QueryCache* get_query_cache(std::string& key, const char* operation, size_t column_ndx, size_t start, size_t end,
+                                size_t limit) const;
+    const QueryCache::Result* find_cached(QueryCache& cache, const std::string& key) const;
+
+    // Set-at-a-time evaluation through RowBitmap, used instead of aggregate_internal() when the top level of the
+    // query contains OR or NOT conditions. Must be called after init().
+    bool use_bitmap_evaluation() const;
+    template <class F>
+    void find_all_bitmap(size_t start, size_t end, F func) const;
+    size_t count_bitmap(size_t start, size_t end, size_t limit) const;
+
     bool has_conditions() const
     {
         return m_groups.size() > 0 && m_groups[0].m_root_node;
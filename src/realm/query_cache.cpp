@@ -0,0 +1,53 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <utility>
+
+#include <realm/query_cache.hpp>
+
+using namespace realm;
+
+QueryCache::QueryCache(size_t max_entries)
+    : m_max_entries(max_entries)
+{
+}
+
+const QueryCache::Result* QueryCache::find(const std::string& key) const
+{
+    auto it = m_results.find(key);
+    if (it == m_results.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    return &it->second;
+}
+
+void QueryCache::insert(const std::string& key, Result result)
+{
+    // Repeated queries are typically issued in bursts against one snapshot,
+    // so starting over is good enough and keeps the bookkeeping trivial
+    if (m_results.size() >= m_max_entries)
+        m_results.clear();
+    m_results[key] = std::move(result);
+}
+
+void QueryCache::clear() noexcept
+{
+    m_results.clear();
+}
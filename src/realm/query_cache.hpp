@@ -0,0 +1,88 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_QUERY_CACHE_HPP
+#define REALM_QUERY_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+
+/// Results of queries evaluated against the current snapshot of a
+/// SharedGroup (see SharedGroupOptions::enable_query_cache).
+///
+/// Entries are keyed by the operation, its arguments, Query::get_description()
+/// and the version of the queried table, as built by Query. The SharedGroup
+/// empties the cache whenever it leaves the snapshot. Like the SharedGroup
+/// itself, a cache must not be accessed by more than one thread at a time.
+class QueryCache {
+public:
+    struct Result {
+        int64_t value = 0;         // Count, or sum for sum_int()
+        size_t result_count = 0;   // Number of rows aggregated by sum_int()
+        std::vector<size_t> rows;  // Matching rows for find_all()
+    };
+
+    /// The cache is emptied rather than grown beyond \a max_entries results.
+    explicit QueryCache(size_t max_entries = 1000);
+
+    /// Returns the result stored under \a key, or null if there is none.
+    const Result* find(const std::string& key) const;
+
+    /// Store \a result under \a key, replacing any previous result.
+    void insert(const std::string& key, Result result);
+
+    void clear() noexcept;
+    size_t size() const noexcept;
+
+    /// Number of lookups that found a result, and number that did not,
+    /// since the cache was created.
+    size_t num_hits() const noexcept;
+    size_t num_misses() const noexcept;
+
+private:
+    std::unordered_map<std::string, Result> m_results;
+    size_t m_max_entries;
+    mutable size_t m_hits = 0;
+    mutable size_t m_misses = 0;
+};
+
+
+// Implementation:
+
+inline size_t QueryCache::size() const noexcept
+{
+    return m_results.size();
+}
+
+inline size_t QueryCache::num_hits() const noexcept
+{
+    return m_hits;
+}
+
+inline size_t QueryCache::num_misses() const noexcept
+{
+    return m_misses;
+}
+
+} // namespace realm
+
+#endif // REALM_QUERY_CACHE_HPP
@@ -51,6 +51,128 @@ size_t ParentNode::find_first(size_t start, size_t end)
     return not_found;
 }
 
+void ParentNode::evaluate_bitmap(RowBitmap& matches)
+{
+    size_t end = matches.end();
+    size_t s = matches.begin();
+    while (s < end) {
+        s = find_first_local(s, end);
+        if (s == not_found || s >= end)
+            break;
+        matches.set(s);
+        ++s;
+    }
+}
+
+void ParentNode::find_all_bitmap(RowBitmap& matches)
+{
+    REALM_ASSERT_DEBUG(!m_bitmap_order.empty() && m_bitmap_order.size() == m_children.size());
+
+    // Evaluate the cheapest condition over the full range first. The following ones only have to look at the rows
+    // that are still candidates, which they either probe one at a time or, if there are many, evaluate in bulk and
+    // intersect.
+    m_bitmap_order[0]->evaluate_bitmap(matches);
+
+    for (size_t c = 1; c < m_bitmap_order.size(); ++c) {
+        size_t candidates = matches.count();
+        if (candidates == 0)
+            return;
+
+        ParentNode* node = m_bitmap_order[c];
+        if (candidates < matches.size() / bitmap_probe_ratio) {
+            matches.for_each([&](size_t row) {
+                if (node->find_first_local(row, row + 1) != row)
+                    matches.unset(row);
+                return true;
+            });
+        }
+        else {
+            m_bitmap_scratch.reset(matches.begin(), matches.end());
+            node->evaluate_bitmap(m_bitmap_scratch);
+            matches.intersect(m_bitmap_scratch);
+        }
+    }
+}
+
+void ParentNode::init_composite_index()
+{
+    using Op = IndexCondition::Op;
+    using Bound = CompositeIndex::Bound;
+
+    const auto& indexes = m_table->get_composite_indexes();
+    if (indexes.empty())
+        return;
+
+    std::vector<std::pair<ParentNode*, IndexCondition>> conditions;
+    for (ParentNode* node = this; node; node = node->m_child.get()) {
+        IndexCondition cond;
+        if (node->get_index_condition(cond))
+            conditions.emplace_back(node, std::move(cond));
+    }
+    if (conditions.empty())
+        return;
+
+    // Use the index that covers the most conditions: equalities on a prefix of its columns, then a lower and/or an
+    // upper bound on the next one. Only nodes on int and Timestamp columns can take over the rows it finds.
+    CompositeIndex* best_index = nullptr;
+    size_t best_count = 0;
+    ParentNode* best_taker = nullptr;
+    std::string best_prefix;
+    const IndexCondition* best_lower = nullptr;
+    const IndexCondition* best_upper = nullptr;
+    for (const auto& index : indexes) {
+        size_t count = 0;
+        ParentNode* taker = nullptr;
+        std::string prefix;
+        const IndexCondition* lower = nullptr;
+        const IndexCondition* upper = nullptr;
+        auto cover = [&](const std::pair<ParentNode*, IndexCondition>& c) {
+            ++count;
+            if (!taker && c.second.takes_rows)
+                taker = c.first;
+        };
+        for (size_t col_ndx : index->get_columns()) {
+            auto equal = std::find_if(conditions.begin(), conditions.end(), [&](const auto& c) {
+                return c.second.column == col_ndx && c.second.op == Op::equal;
+            });
+            if (equal != conditions.end()) {
+                prefix += equal->second.key;
+                cover(*equal);
+                continue;
+            }
+            for (const auto& c : conditions) {
+                if (c.second.column != col_ndx)
+                    continue;
+                bool is_lower = (c.second.op == Op::greater || c.second.op == Op::greater_equal);
+                const IndexCondition*& bound = is_lower ? lower : upper;
+                if (!bound) {
+                    bound = &c.second;
+                    cover(c);
+                }
+            }
+            break;
+        }
+        if (taker && count > best_count) {
+            best_index = index.get();
+            best_count = count;
+            best_taker = taker;
+            best_prefix = std::move(prefix);
+            best_lower = lower;
+            best_upper = upper;
+        }
+    }
+    if (!best_index)
+        return;
+
+    best_index->refresh(*m_table, m_table->get_version_counter()); // Throws
+    Bound lower = !best_lower ? Bound::unbounded : best_lower->op == Op::greater ? Bound::exclusive : Bound::inclusive;
+    Bound upper = !best_upper ? Bound::unbounded : best_upper->op == Op::less ? Bound::exclusive : Bound::inclusive;
+    std::vector<size_t> rows;
+    best_index->find_rows(best_prefix, lower, best_lower ? best_lower->key : std::string(), upper,
+                          best_upper ? best_upper->key : std::string(), rows); // Throws
+    best_taker->set_index_candidates(rows);
+}
+
 void ParentNode::aggregate_local_prepare(Action TAction, DataType col_id, bool nullable)
 {
     if (TAction == act_ReturnFirst) {
@@ -399,6 +521,15 @@ size_t StringNode<EqualIns>::_find_first_local(size_t start, size_t end)
 
 } // namespace realm
 
+void OrNode::evaluate_bitmap(RowBitmap& matches)
+{
+    for (auto& condition : m_conditions) {
+        m_condition_matches.reset(matches.begin(), matches.end());
+        condition->find_all_bitmap(m_condition_matches);
+        matches.unite(m_condition_matches);
+    }
+}
+
 size_t NotNode::find_first_local(size_t start, size_t end)
 {
     if (start <= m_known_range_start && end >= m_known_range_end) {
@@ -89,6 +89,8 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <sstream>
 #include <string>
 #include <array>
+#include <unordered_set>
+#include <vector>
 
 #include <realm/array_basic.hpp>
 #include <realm/array_string.hpp>
@@ -103,6 +105,7 @@ AggregateState      State of the aggregate - contains a state variable that stor
 #include <realm/column_timestamp.hpp>
 #include <realm/column_type_traits.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/impl/row_bitmap.hpp>
 #include <realm/impl/sequential_getter.hpp>
 #include <realm/link_view.hpp>
 #include <realm/metrics/query_info.hpp>
@@ -137,6 +140,20 @@ const size_t probe_matches = 4;
 
 const size_t bitwidth_time_unit = 64;
 
+// Number of rows evaluated at a time when a query is run set-at-a-time into a RowBitmap (see
+// ParentNode::find_all_bitmap()). Large enough to amortize the per-node overhead, small enough for the bitmaps to
+// stay in L1 cache.
+const size_t bitmap_chunk_size = 8 * 1024;
+
+// In set-at-a-time evaluation, the remaining conditions of an AND chain are probed row by row instead of being
+// evaluated into a bitmap of their own when less than 1/bitmap_probe_ratio of the rows are still candidates.
+const size_t bitmap_probe_ratio = 16;
+
+// Greater(), less() and similar conditions on a column with a range index only take their matches from the index if
+// they match at most 1/range_index_max_ratio of the rows. Beyond that, scanning the column is faster than sorting
+// the row numbers of the matches.
+const size_t range_index_max_ratio = 4;
+
 typedef bool (*CallbackDummy)(int64_t);
 
 class ParentNode {
@@ -158,6 +175,12 @@ public:
         m_children = v;
         m_children.erase(m_children.begin() + i);
         m_children.insert(m_children.begin(), this);
+
+        // Costs are final once init() has run, which always precedes this call, so the evaluation order used by
+        // find_all_bitmap() can be fixed here instead of for every chunk.
+        m_bitmap_order = m_children;
+        std::stable_sort(m_bitmap_order.begin(), m_bitmap_order.end(),
+                         [](const ParentNode* a, const ParentNode* b) { return a->cost() < b->cost(); });
     }
 
     double cost() const
@@ -192,6 +215,20 @@ public:
 
     virtual size_t find_first_local(size_t start, size_t end) = 0;
 
+    // Set-at-a-time evaluation. evaluate_bitmap() sets the bit of every row in the range of `matches` that satisfies
+    // the condition of this node alone (m_child is ignored). find_all_bitmap() does the same for the entire AND
+    // chain headed by this node. `matches` must be empty on entry. The default implementation of evaluate_bitmap()
+    // is built on find_first_local().
+    virtual void evaluate_bitmap(RowBitmap& matches);
+    void find_all_bitmap(RowBitmap& matches);
+
+    // True for nodes that are much cheaper to evaluate set-at-a-time than row by row (OR and NOT). The query
+    // switches to bitmap evaluation if any node of the top level AND chain returns true.
+    virtual bool prefers_bitmap_evaluation() const
+    {
+        return false;
+    }
+
     virtual void aggregate_local_prepare(Action TAction, DataType col_id, bool nullable);
 
     template <Action TAction, class TSourceColumn>
@@ -301,8 +338,56 @@ public:
         return s;
     }
 
+    // True if describe() captures everything the condition depends on, so
+    // that conditions with equal descriptions match the same rows. Required
+    // for caching query results by description.
+    virtual bool describe_is_exact() const
+    {
+        return false;
+    }
+
+    bool describe_expression_is_exact() const
+    {
+        return describe_is_exact() && (!m_child || m_child->describe_expression_is_exact());
+    }
+
+    // A condition that a CompositeIndex can answer: the value of `column` compared by `op` to the value whose index key
+    // is `key`. `takes_rows` tells whether the node supports set_index_candidates().
+    struct IndexCondition {
+        enum class Op { equal, greater, greater_equal, less, less_equal };
+        size_t column;
+        Op op;
+        std::string key;
+        bool takes_rows = false;
+    };
+
+    // Describes the condition of this node for a composite index, if it can be answered by one
+    virtual bool get_index_condition(IndexCondition&) const
+    {
+        return false;
+    }
+
+    // Makes this node match exactly the rows in `rows` (ascending), which a composite index found to satisfy the
+    // condition of this node along with others. `rows` may be swapped with the node's own storage.
+    virtual void set_index_candidates(std::vector<size_t>&)
+    {
+        REALM_ASSERT(false);
+    }
+
+    // Looks up the conditions of the AND chain headed by this node in the composite indexes of the table (see
+    // Table::add_composite_index()), and hands the rows found by the best one to one of the nodes it covers. Must be
+    // called after init().
+    void init_composite_index();
+
+    // Column names need not be unique, but describe_column() only uses the name
+    bool describe_column_is_exact(size_t col_ndx) const
+    {
+        return m_table && col_ndx != npos && m_table->get_column_index(m_table->get_column_name(col_ndx)) == col_ndx;
+    }
+
     std::unique_ptr<ParentNode> m_child;
     std::vector<ParentNode*> m_children;
+    std::vector<ParentNode*> m_bitmap_order; // m_children by ascending cost()
     size_t m_condition_column_idx = npos; // Column of search criteria
 
     double m_dD;       // Average row distance between each local match at current position
@@ -358,9 +443,33 @@ protected:
     }
 
 private:
+    // Reused across chunks by find_all_bitmap() so that only the first chunk allocates
+    RowBitmap m_bitmap_scratch{0, 0};
+
     virtual void table_changed() = 0;
 };
 
+// The operation of a condition as seen by a composite index, if it has one, see ParentNode::get_index_condition()
+template <class TConditionFunction>
+inline bool get_index_op(ParentNode::IndexCondition::Op&)
+{
+    return false;
+}
+
+#define REALM_INDEX_OP(Cond, index_op)                                                                               \
+    template <>                                                                                                      \
+    inline bool get_index_op<Cond>(ParentNode::IndexCondition::Op & op)                                              \
+    {                                                                                                                \
+        op = ParentNode::IndexCondition::Op::index_op;                                                               \
+        return true;                                                                                                 \
+    }
+REALM_INDEX_OP(Equal, equal)
+REALM_INDEX_OP(Greater, greater)
+REALM_INDEX_OP(GreaterEqual, greater_equal)
+REALM_INDEX_OP(Less, less)
+REALM_INDEX_OP(LessEqual, less_equal)
+#undef REALM_INDEX_OP
+
 // For conditions on a subtable (encapsulated in subtable()...end_subtable()). These return the parent row as match if
 // and only if one or more subtable rows match the condition.
 class SubtableNode : public ParentNode {
@@ -756,16 +865,29 @@ public:
     {
     }
 
+    void init() override
+    {
+        BaseType::init();
+
+        using IsRange = std::integral_constant<bool, is_any<TConditionFunction, Equal, Greater, GreaterEqual,
+                                                            Less, LessEqual>::value>;
+        init_range_candidates(IsRange());
+    }
+
     void aggregate_local_prepare(Action action, DataType col_id, bool nullable) override
     {
         this->m_fastmode_disabled = (col_id == type_Float || col_id == type_Double);
         this->m_action = action;
         this->m_find_callback_specialized = get_specialized_callback(action, col_id, nullable);
+        // Used instead when the matches come from the range index
+        ParentNode::aggregate_local_prepare(action, col_id, nullable);
     }
 
     size_t aggregate_local(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
                            SequentialGetterBase* source_column) override
     {
+        if (m_use_candidates)
+            return ParentNode::aggregate_local(st, start, end, local_limit, source_column);
         constexpr int cond = TConditionFunction::condition;
         return this->aggregate_local_impl(st, start, end, local_limit, source_column, cond);
     }
@@ -774,6 +896,11 @@ public:
     {
         REALM_ASSERT(this->m_table);
 
+        if (m_use_candidates) {
+            auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), start);
+            return (it != m_candidates.end() && *it < end) ? *it : not_found;
+        }
+
         while (start < end) {
 
             // Cache internal leaves
@@ -806,11 +933,38 @@ public:
         return not_found;
     }
 
+    void evaluate_bitmap(RowBitmap& matches) override
+    {
+        if (m_use_candidates) {
+            auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), matches.begin());
+            for (; it != m_candidates.end() && *it < matches.end(); ++it)
+                matches.set(*it);
+            return;
+        }
+
+        auto set_match = [&matches](int64_t i) {
+            matches.set(to_size_t(i));
+            return true;
+        };
+        for (size_t s = matches.begin(); s < matches.end();) {
+            this->cache_leaf(s);
+            size_t end_in_leaf = std::min(matches.end(), this->m_leaf_end) - this->m_leaf_start;
+            this->m_leaf_ptr->template find<TConditionFunction, act_CallbackIdx>(
+                this->m_value, s - this->m_leaf_start, end_in_leaf, this->m_leaf_start, nullptr, set_match);
+            s = this->m_leaf_start + end_in_leaf;
+        }
+    }
+
     virtual std::string describe() const override
     {
         return this->describe_column() + " " + describe_condition() + " " + metrics::print_value(IntegerNodeBase<ColType>::m_value);
     }
 
+    bool describe_is_exact() const override
+    {
+        return this->describe_column_is_exact(this->m_condition_column_idx);
+    }
+
     virtual std::string describe_condition() const override
     {
         return TConditionFunction::description();
@@ -821,9 +975,57 @@ public:
         return std::unique_ptr<ParentNode>(new IntegerNode<ColType, TConditionFunction>(*this, patches));
     }
 
+    bool get_index_condition(ParentNode::IndexCondition& cond) const override
+    {
+        int64_t value;
+        if (!get_index_op<TConditionFunction>(cond.op) || !RangeIndex<int64_t>::get_key(this->m_value, value))
+            return false;
+        cond.column = this->m_condition_column_idx;
+        cond.key.clear();
+        CompositeIndex::append_int(cond.key, value);
+        cond.takes_rows = true;
+        return true;
+    }
+
+    void set_index_candidates(std::vector<size_t>& rows) override
+    {
+        m_candidates.swap(rows);
+        m_use_candidates = true;
+        this->m_dT = 0.0;
+        this->m_dD = double(this->m_table->size()) / (m_candidates.size() + 1);
+    }
+
 protected:
     using TFind_callback_specialized = typename BaseType::TFind_callback_specialized;
 
+    // The matching rows, if they were looked up in the range index of the column, see init_range_candidates()
+    bool m_use_candidates = false;
+    std::vector<size_t> m_candidates;
+
+    void init_range_candidates(std::false_type)
+    {
+    }
+
+    // Looks up the matches of an equal(), greater(), less() or similar condition in the range index of the column, if
+    // it has one. Sets m_use_candidates unless there are so many matches that scanning the column is cheaper.
+    void init_range_candidates(std::true_type)
+    {
+        m_use_candidates = false;
+        m_candidates.clear();
+        auto index = this->m_condition_column->get_range_index();
+        int64_t key;
+        if (!index || !index->get_key(this->m_value, key))
+            return;
+
+        index->refresh(*this->m_condition_column, this->m_table->get_version_counter()); // Throws
+        size_t max_rows = this->m_table->size() / range_index_max_ratio;
+        m_use_candidates = index->template find_rows<TConditionFunction>(key, max_rows, m_candidates); // Throws
+        if (m_use_candidates) {
+            this->m_dT = 0.0;
+            this->m_dD = double(this->m_table->size()) / (m_candidates.size() + 1);
+        }
+    }
+
     static TFind_callback_specialized get_specialized_callback(Action action, DataType col_id, bool nullable)
     {
         switch (action) {
@@ -920,10 +1122,19 @@ public:
     {
         ParentNode::init();
         m_dD = 100.0;
+
+        using IsRange = std::integral_constant<bool, is_any<TConditionFunction, Equal, Greater, GreaterEqual,
+                                                            Less, LessEqual>::value>;
+        init_range_candidates(IsRange());
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_use_candidates) {
+            auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), start);
+            return (it != m_candidates.end() && *it < end) ? *it : not_found;
+        }
+
         TConditionFunction cond;
 
         auto find = [&](bool nullability) {
@@ -968,6 +1179,31 @@ public:
 protected:
     TConditionValue m_value;
     SequentialGetter<ColType> m_condition_column;
+
+    // The matching rows, if they were looked up in the range index of the column, see IntegerNode
+    bool m_use_candidates = false;
+    std::vector<size_t> m_candidates;
+
+    void init_range_candidates(std::false_type)
+    {
+    }
+
+    void init_range_candidates(std::true_type)
+    {
+        m_use_candidates = false;
+        m_candidates.clear();
+        const ColType* column = m_condition_column.m_column;
+        auto index = column->get_range_index();
+        TConditionValue key;
+        if (!index || !index->get_key(m_value, key))
+            return;
+
+        index->refresh(*column, m_table->get_version_counter()); // Throws
+        size_t max_rows = m_table->size() / range_index_max_ratio;
+        m_use_candidates = index->template find_rows<TConditionFunction>(key, max_rows, m_candidates); // Throws
+        if (m_use_candidates)
+            m_dD = double(m_table->size()) / (m_candidates.size() + 1);
+    }
 };
 
 template <class ColType, class TConditionFunction>
@@ -1135,10 +1371,19 @@ public:
         ParentNode::init();
 
         m_dD = 100.0;
+
+        using IsRange = std::integral_constant<bool, is_any<TConditionFunction, Equal, Greater, GreaterEqual,
+                                                            Less, LessEqual>::value>;
+        init_range_candidates(IsRange());
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_use_candidates) {
+            auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), start);
+            return (it != m_candidates.end() && *it < end) ? *it : not_found;
+        }
+
         size_t ret = m_condition_column->find<TConditionFunction>(m_value, start, end);
         return ret;
     }
@@ -1148,6 +1393,30 @@ public:
         return this->describe_column() + " " + TConditionFunction::description() + " " + metrics::print_value(TimestampNode::m_value);
     }
 
+    bool describe_is_exact() const override
+    {
+        // Null is printed like Timestamp(0, 0)
+        return describe_column_is_exact(m_condition_column_idx) && !m_value.is_null();
+    }
+
+    bool get_index_condition(IndexCondition& cond) const override
+    {
+        if (!get_index_op<TConditionFunction>(cond.op) || m_value.is_null())
+            return false;
+        cond.column = m_condition_column_idx;
+        cond.key.clear();
+        CompositeIndex::append_timestamp(cond.key, m_value);
+        cond.takes_rows = true;
+        return true;
+    }
+
+    void set_index_candidates(std::vector<size_t>& rows) override
+    {
+        m_candidates.swap(rows);
+        m_use_candidates = true;
+        m_dD = double(m_table->size()) / (m_candidates.size() + 1);
+    }
+
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
         return std::unique_ptr<ParentNode>(new TimestampNode(*this, patches));
@@ -1165,6 +1434,29 @@ public:
 private:
     Timestamp m_value;
     const TimestampColumn* m_condition_column;
+
+    // The matching rows, if they were looked up in the range index of the column, see IntegerNode
+    bool m_use_candidates = false;
+    std::vector<size_t> m_candidates;
+
+    void init_range_candidates(std::false_type)
+    {
+    }
+
+    void init_range_candidates(std::true_type)
+    {
+        m_use_candidates = false;
+        m_candidates.clear();
+        RangeIndex<Timestamp>* index = m_condition_column->get_range_index();
+        if (!index || m_value.is_null())
+            return;
+
+        index->refresh(*m_condition_column, m_table->get_version_counter()); // Throws
+        size_t max_rows = m_table->size() / range_index_max_ratio;
+        m_use_candidates = index->template find_rows<TConditionFunction>(m_value, max_rows, m_candidates); // Throws
+        if (m_use_candidates)
+            m_dD = double(m_table->size()) / (m_candidates.size() + 1);
+    }
 };
 
 class StringNodeBase : public ParentNode {
@@ -1222,6 +1514,13 @@ public:
         return this->describe_column() + " " + describe_condition() + " \"" + metrics::print_value(StringNodeBase::m_value) + "\"";
     }
 
+    bool describe_is_exact() const override
+    {
+        // A quote in the value could make the description read like a different query
+        return describe_column_is_exact(m_condition_column_idx) &&
+               (!m_value || m_value->find('"') == std::string::npos);
+    }
+
 protected:
     util::Optional<std::string> m_value;
 
@@ -1234,6 +1533,46 @@ protected:
     size_t m_end_s = 0;
     size_t m_leaf_start = 0;
     size_t m_leaf_end = 0;
+
+    // Rows found by the n-gram index of the column to be the only ones that can match, see init_ngram_candidates()
+    bool m_use_candidates = false;
+    std::vector<size_t> m_candidates;
+
+    // Looks up the needle of a substring condition (or the literal runs of a like() pattern) in the n-gram index of
+    // the column, if it has one. Sets m_use_candidates if the index could narrow down the rows to test.
+    void init_ngram_candidates(StringData needle, bool like, bool case_insensitive)
+    {
+        m_use_candidates = false;
+        m_candidates.clear();
+        if (m_column_type != col_type_String || needle.is_null())
+            return;
+        const StringColumn* column = static_cast<const StringColumn*>(m_condition_column);
+        NGramIndex* index = column->get_ngram_index();
+        if (!index)
+            return;
+
+        index->refresh(*column, m_table->get_version_counter()); // Throws
+        if (like)
+            m_use_candidates = index->find_like_candidates(needle, case_insensitive, m_candidates); // Throws
+        else
+            m_use_candidates = index->find_candidates(needle, case_insensitive, m_candidates); // Throws
+        if (m_use_candidates) {
+            m_dT = 0.0;
+            m_dD = double(m_table->size()) / (m_candidates.size() + 1);
+        }
+    }
+
+    // Returns the first of the candidate rows in [start, end) whose string satisfies `match`
+    template <class F>
+    size_t find_first_candidate(size_t start, size_t end, F match)
+    {
+        auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), start);
+        for (; it != m_candidates.end() && *it < end; ++it) {
+            if (match(get_string(*it)))
+                return *it;
+        }
+        return not_found;
+    }
     
     inline StringData get_string(size_t s)
     {
@@ -1273,6 +1612,30 @@ protected:
     }
 };
 
+// Whether matches of a string condition must contain its value as a substring (`substring`), or the literal runs of
+// its value as a like() pattern (`like`), so that an n-gram index can find the candidate rows.
+template <class TConditionFunction>
+struct NGramUse {
+    static const bool substring = false;
+    static const bool like = false;
+    static const bool case_insensitive = false;
+};
+
+#define REALM_NGRAM_USE(Cond, is_substring, is_like, is_case_insensitive)                                            \
+    template <>                                                                                                      \
+    struct NGramUse<Cond> {                                                                                          \
+        static const bool substring = is_substring;                                                                  \
+        static const bool like = is_like;                                                                            \
+        static const bool case_insensitive = is_case_insensitive;                                                    \
+    };
+REALM_NGRAM_USE(BeginsWith, true, false, false)
+REALM_NGRAM_USE(BeginsWithIns, true, false, true)
+REALM_NGRAM_USE(EndsWith, true, false, false)
+REALM_NGRAM_USE(EndsWithIns, true, false, true)
+REALM_NGRAM_USE(Like, false, true, false)
+REALM_NGRAM_USE(LikeIns, false, true, true)
+#undef REALM_NGRAM_USE
+
 // Conditions for strings. Note that Equal is specialized later in this file!
 template <class TConditionFunction>
 class StringNode : public StringNodeBase {
@@ -1298,6 +1661,10 @@ public:
         m_dD = 100.0;
 
         StringNodeBase::init();
+
+        using Use = NGramUse<TConditionFunction>;
+        if (Use::substring || Use::like)
+            init_ngram_candidates(StringData(m_value), Use::like, Use::case_insensitive);
     }
 
 
@@ -1305,6 +1672,12 @@ public:
     {
         TConditionFunction cond;
 
+        if (m_use_candidates) {
+            return find_first_candidate(start, end, [&](StringData t) {
+                return cond(StringData(m_value), m_ucase.data(), m_lcase.data(), t);
+            });
+        }
+
         for (size_t s = start; s < end; ++s) {
             StringData t = get_string(s);
             
@@ -1336,26 +1709,14 @@ protected:
     std::string m_lcase;
 };
 
-// Specialization for Contains condition on Strings - we specialize because we can utilize Boyer-Moore
+// Specialization for Contains condition on Strings - we specialize because we can use the vectorized
+// StringData::find() directly instead of going through the Contains functor
 template <>
 class StringNode<Contains> : public StringNodeBase {
 public:
     StringNode(StringData v, size_t column)
-    : StringNodeBase(v, column), m_charmap()
+    : StringNodeBase(v, column)
     {
-        if (v.size() == 0)
-            return;
-        
-        // Build a dictionary of char-to-last distances in the search string
-        // (zero indicates that the char is not in needle)
-        size_t last_char_pos = v.size()-1;
-        for (size_t i = 0; i < last_char_pos; ++i) {
-            // we never jump longer increments than 255 chars, even if needle is longer (to fit in one byte)
-            uint8_t jump = last_char_pos-i < 255 ? static_cast<uint8_t>(last_char_pos-i) : 255;
-            
-            unsigned char c = v[i];
-            m_charmap[c] = jump;
-        }
     }
     
     void init() override
@@ -1365,17 +1726,26 @@ public:
         m_dD = 100.0;
         
         StringNodeBase::init();
+
+        init_ngram_candidates(StringData(m_value), false, false);
     }
     
     
     size_t find_first_local(size_t start, size_t end) override
     {
-        Contains cond;
-        
+        StringData needle(m_value);
+        size_t needle_size = needle.size();
+        auto match = [&](StringData t) {
+            if (t.is_null() && !needle.is_null())
+                return false;
+            return needle_size == 0 || (t.size() >= needle_size && t.find(needle) != t.size());
+        };
+
+        if (m_use_candidates)
+            return find_first_candidate(start, end, match);
+
         for (size_t s = start; s < end; ++s) {
-            StringData t = get_string(s);
-            
-            if (cond(StringData(m_value), m_charmap, t))
+            if (match(get_string(s)))
                 return s;
         }
         return not_found;
@@ -1394,12 +1764,8 @@ public:
     
     StringNode(const StringNode& from, QueryNodeHandoverPatches* patches)
     : StringNodeBase(from, patches)
-    , m_charmap(from.m_charmap)
     {
     }
-    
-protected:
-    std::array<uint8_t, 256> m_charmap;
 };
 
 // Specialization for ContainsIns condition on Strings - we specialize because we can utilize Boyer-Moore
@@ -1418,6 +1784,10 @@ public:
             m_ucase = std::move(*upper);
             m_lcase = std::move(*lower);
         }
+
+        // A needle without multi-byte characters can be matched byte by byte
+        m_ascii = std::all_of(m_ucase.begin(), m_ucase.end(), [](char c) { return (c & 0x80) == 0; }) &&
+                  std::all_of(m_lcase.begin(), m_lcase.end(), [](char c) { return (c & 0x80) == 0; });
         
         if (v.size() == 0)
             return;
@@ -1444,17 +1814,38 @@ public:
         m_dD = 100.0;
         
         StringNodeBase::init();
+
+        init_ngram_candidates(StringData(m_value), false, true);
     }
     
     
     size_t find_first_local(size_t start, size_t end) override
     {
+        size_t needle_size = m_ucase.size();
+        if (m_ascii && needle_size != 0) {
+            auto match = [&](StringData t) {
+                return t.size() >= needle_size &&
+                       search_case_fold_ascii(t, m_ucase.data(), m_lcase.data(), needle_size) != t.size();
+            };
+            if (m_use_candidates)
+                return find_first_candidate(start, end, match);
+            for (size_t s = start; s < end; ++s) {
+                if (match(get_string(s)))
+                    return s;
+            }
+            return not_found;
+        }
+
         ContainsIns cond;
+        auto match = [&](StringData t) {
+            return cond(StringData(m_value), m_ucase.data(), m_lcase.data(), m_charmap, t);
+        };
+
+        if (m_use_candidates)
+            return find_first_candidate(start, end, match);
         
         for (size_t s = start; s < end; ++s) {
-            StringData t = get_string(s);
-            
-            if (cond(StringData(m_value), m_ucase.data(), m_lcase.data(), m_charmap, t))
+            if (match(get_string(s)))
                 return s;
         }
         return not_found;
@@ -1475,6 +1866,7 @@ public:
     , m_charmap(from.m_charmap)
     , m_ucase(from.m_ucase)
     , m_lcase(from.m_lcase)
+    , m_ascii(from.m_ascii)
     {
     }
     
@@ -1482,6 +1874,7 @@ protected:
     std::array<uint8_t, 256> m_charmap;
     std::string m_ucase;
     std::string m_lcase;
+    bool m_ascii = false;
 };
 
 class StringNodeEqualBase : public StringNodeBase {
@@ -1543,6 +1936,17 @@ public:
 
     void _search_index_init() override;
 
+    bool get_index_condition(IndexCondition& cond) const override
+    {
+        if (!m_value)
+            return false;
+        cond.column = m_condition_column_idx;
+        cond.op = IndexCondition::Op::equal;
+        cond.key.clear();
+        CompositeIndex::append_string(cond.key, StringData(*m_value));
+        return true;
+    }
+
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
         return std::unique_ptr<ParentNode>(new StringNode<Equal>(*this, patches));
@@ -1599,6 +2003,363 @@ private:
 };
 
 
+// Row indexes matched by an IN condition on an indexed column. All values are looked up in the search index once,
+// when the query is initialized, and the results are merged into one ascending list that is then walked by
+// find_first().
+class InIndexMatches {
+public:
+    template <class T>
+    void init(const StringIndex& index, const std::vector<T>& values)
+    {
+        IntegerColumn matches(IntegerColumn::unattached_root_tag(), Allocator::get_default()); // Throws
+        matches.get_root_array()->create(Array::type_Normal);                                    // Throws
+        for (const T& value : values)
+            index.find_all(matches, value); // Throws
+
+        size_t sz = matches.size();
+        m_rows.clear();
+        m_rows.reserve(sz);
+        for (size_t i = 0; i < sz; ++i)
+            m_rows.push_back(to_size_t(matches.get(i)));
+        matches.destroy();
+
+        // Each lookup yields a sorted run, but the runs of different values interleave
+        std::sort(m_rows.begin(), m_rows.end());
+        m_rows.erase(std::unique(m_rows.begin(), m_rows.end()), m_rows.end());
+    }
+
+    void clear() noexcept
+    {
+        m_rows.clear();
+    }
+
+    size_t find_first(size_t start, size_t end) const
+    {
+        auto it = std::lower_bound(m_rows.begin(), m_rows.end(), start);
+        if (it != m_rows.end() && *it < end)
+            return *it;
+        return not_found;
+    }
+
+private:
+    std::vector<size_t> m_rows;
+};
+
+// Membership condition on an integer column: 'column IN {v1, v2, ...}'. Without a search index every row is probed
+// by binary search in the sorted list of values, after a cheap range check against its smallest and largest element.
+template <class ColType>
+class IntegerInNode : public ParentNode {
+public:
+    IntegerInNode(std::vector<int64_t> values, size_t column)
+        : m_values(std::move(values))
+    {
+        m_condition_column_idx = column;
+        std::sort(m_values.begin(), m_values.end());
+        m_values.erase(std::unique(m_values.begin(), m_values.end()), m_values.end());
+    }
+
+    void table_changed() override
+    {
+        m_condition_column = &get_column<ColType>(m_condition_column_idx);
+    }
+
+    void verify_column() const override
+    {
+        do_verify_column(m_condition_column);
+    }
+
+    void init() override
+    {
+        ParentNode::init();
+
+        m_dD = 100.0;
+        m_index_matches.clear();
+        m_has_index = m_condition_column->has_search_index();
+        if (m_has_index) {
+            m_dT = 0.0;
+            m_index_matches.init(*m_condition_column->get_search_index(), m_values);
+        }
+        else {
+            m_dT = 1.0;
+            m_getter.init(m_condition_column);
+        }
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_has_index)
+            return m_index_matches.find_first(start, end);
+        if (m_values.empty())
+            return not_found;
+
+        for (size_t s = start; s < end;) {
+            m_getter.cache_next(s);
+            size_t end_in_leaf = m_getter.local_end(end);
+            for (size_t i = s - m_getter.m_leaf_start; i < end_in_leaf; ++i) {
+                if (contains(m_getter.m_leaf_ptr->get(i)))
+                    return m_getter.m_leaf_start + i;
+            }
+            s = m_getter.m_leaf_start + end_in_leaf;
+        }
+        return not_found;
+    }
+
+    virtual std::string describe() const override
+    {
+        std::string values;
+        for (int64_t v : m_values)
+            values += (values.empty() ? "" : ", ") + metrics::print_value(v);
+        return this->describe_column() + " " + describe_condition() + " {" + values + "}";
+    }
+
+    virtual std::string describe_condition() const override
+    {
+        return "IN";
+    }
+
+    bool describe_is_exact() const override
+    {
+        return describe_column_is_exact(m_condition_column_idx);
+    }
+
+    std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        return std::unique_ptr<ParentNode>(new IntegerInNode(*this, patches));
+    }
+
+    IntegerInNode(const IntegerInNode& from, QueryNodeHandoverPatches* patches)
+        : ParentNode(from, patches)
+        , m_values(from.m_values)
+        , m_condition_column(from.m_condition_column)
+    {
+        if (m_condition_column && patches)
+            m_condition_column_idx = m_condition_column->get_column_index();
+    }
+
+private:
+    std::vector<int64_t> m_values; // Sorted, without duplicates
+    const ColType* m_condition_column = nullptr;
+    bool m_has_index = false;
+    InIndexMatches m_index_matches;
+    SequentialGetter<ColType> m_getter;
+
+    bool contains(int64_t v) const
+    {
+        if (v < m_values.front() || v > m_values.back())
+            return false;
+        return std::binary_search(m_values.begin(), m_values.end(), v);
+    }
+
+    bool contains(util::Optional<int64_t> v) const
+    {
+        return v && contains(*v);
+    }
+};
+
+// Membership condition on a Timestamp column. A null Timestamp in the list matches null rows.
+class TimestampInNode : public ParentNode {
+public:
+    TimestampInNode(std::vector<Timestamp> values, size_t column)
+        : m_values(std::move(values))
+    {
+        m_condition_column_idx = column;
+        std::sort(m_values.begin(), m_values.end(), less);
+        m_values.erase(std::unique(m_values.begin(), m_values.end()), m_values.end());
+    }
+
+    void table_changed() override
+    {
+        m_condition_column = &get_column<TimestampColumn>(m_condition_column_idx);
+    }
+
+    void verify_column() const override
+    {
+        do_verify_column(m_condition_column);
+    }
+
+    void init() override
+    {
+        ParentNode::init();
+
+        m_dD = 100.0;
+        m_index_matches.clear();
+        m_has_index = m_condition_column->has_search_index();
+        if (m_has_index) {
+            m_dT = 0.0;
+            m_index_matches.init(*m_condition_column->get_search_index(), m_values);
+        }
+        else {
+            m_dT = 2.0;
+        }
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_has_index)
+            return m_index_matches.find_first(start, end);
+        if (m_values.empty())
+            return not_found;
+
+        for (size_t s = start; s < end; ++s) {
+            if (std::binary_search(m_values.begin(), m_values.end(), m_condition_column->get(s), less))
+                return s;
+        }
+        return not_found;
+    }
+
+    virtual std::string describe() const override
+    {
+        std::string values;
+        for (const Timestamp& v : m_values)
+            values += (values.empty() ? "" : ", ") + metrics::print_value(v);
+        return this->describe_column() + " " + describe_condition() + " {" + values + "}";
+    }
+
+    virtual std::string describe_condition() const override
+    {
+        return "IN";
+    }
+
+    bool describe_is_exact() const override
+    {
+        // Null is printed like Timestamp(0, 0), and sorts first
+        return describe_column_is_exact(m_condition_column_idx) && (m_values.empty() || !m_values.front().is_null());
+    }
+
+    std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        return std::unique_ptr<ParentNode>(new TimestampInNode(*this, patches));
+    }
+
+    TimestampInNode(const TimestampInNode& from, QueryNodeHandoverPatches* patches)
+        : ParentNode(from, patches)
+        , m_values(from.m_values)
+        , m_condition_column(from.m_condition_column)
+    {
+        if (m_condition_column && patches)
+            m_condition_column_idx = m_condition_column->get_column_index();
+    }
+
+private:
+    std::vector<Timestamp> m_values; // Sorted with null first, without duplicates
+    const TimestampColumn* m_condition_column = nullptr;
+    bool m_has_index = false;
+    InIndexMatches m_index_matches;
+
+    // Timestamp::operator<() does not accept null
+    static bool less(const Timestamp& a, const Timestamp& b)
+    {
+        if (a.is_null() || b.is_null())
+            return a.is_null() && !b.is_null();
+        return a < b;
+    }
+};
+
+// Membership condition on a string column. Without a search index every row is probed against a hash set of the
+// values, so the cost per row does not grow with the length of the list as it does for a chain of Or()'ed equal
+// conditions.
+class StringInNode : public StringNodeBase {
+public:
+    StringInNode(const std::vector<StringData>& values, size_t column)
+        : StringNodeBase(StringData(), column)
+    {
+        for (StringData v : values) {
+            if (v.is_null())
+                m_match_null = true;
+            else
+                m_strings.push_back(v);
+        }
+        std::sort(m_strings.begin(), m_strings.end());
+        m_strings.erase(std::unique(m_strings.begin(), m_strings.end()), m_strings.end());
+        build_set();
+    }
+
+    void init() override
+    {
+        StringNodeBase::init();
+
+        m_dD = 100.0;
+        m_index_matches.clear();
+        m_has_index = m_condition_column->has_search_index();
+        if (m_has_index) {
+            m_dT = 0.0;
+            std::vector<StringData> values(m_set.begin(), m_set.end());
+            if (m_match_null)
+                values.push_back(StringData());
+            m_index_matches.init(*m_condition_column->get_search_index(), values);
+        }
+    }
+
+    size_t find_first_local(size_t start, size_t end) override
+    {
+        if (m_has_index)
+            return m_index_matches.find_first(start, end);
+        if (m_set.empty() && !m_match_null)
+            return not_found;
+
+        for (size_t s = start; s < end; ++s) {
+            StringData t = get_string(s);
+            if (t.is_null() ? m_match_null : m_set.count(t) != 0)
+                return s;
+        }
+        return not_found;
+    }
+
+    virtual std::string describe() const override
+    {
+        std::string values = m_match_null ? "NULL" : "";
+        for (const std::string& v : m_strings)
+            values += (values.empty() ? "\"" : ", \"") + metrics::print_value(v) + "\"";
+        return this->describe_column() + " " + describe_condition() + " {" + values + "}";
+    }
+
+    virtual std::string describe_condition() const override
+    {
+        return "IN";
+    }
+
+    bool describe_is_exact() const override
+    {
+        if (!describe_column_is_exact(m_condition_column_idx))
+            return false;
+        for (const std::string& v : m_strings) {
+            if (v.find('"') != std::string::npos)
+                return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        return std::unique_ptr<ParentNode>(new StringInNode(*this, patches));
+    }
+
+    StringInNode(const StringInNode& from, QueryNodeHandoverPatches* patches)
+        : StringNodeBase(from, patches)
+        , m_strings(from.m_strings)
+        , m_match_null(from.m_match_null)
+    {
+        build_set();
+    }
+
+private:
+    std::vector<std::string> m_strings; // Sorted, without duplicates
+    bool m_match_null = false;
+    // Refers to the elements of m_strings
+    std::unordered_set<StringData> m_set;
+    bool m_has_index = false;
+    InIndexMatches m_index_matches;
+
+    void build_set()
+    {
+        m_set.clear();
+        m_set.reserve(m_strings.size());
+        for (const std::string& s : m_strings)
+            m_set.insert(StringData(s));
+    }
+};
+
+
 // OR node contains at least two node pointers: Two or more conditions to OR
 // together in m_conditions, and the next AND condition (if any) in m_child.
 //
@@ -1653,6 +2414,15 @@ public:
         return s;
     }
 
+    bool describe_is_exact() const override
+    {
+        for (const auto& condition : m_conditions) {
+            if (!condition || !condition->describe_expression_is_exact())
+                return false;
+        }
+        return true;
+    }
+
 
     void init() override
     {
@@ -1712,6 +2482,13 @@ public:
         return index;
     }
 
+    void evaluate_bitmap(RowBitmap& matches) override;
+
+    bool prefers_bitmap_evaluation() const override
+    {
+        return true;
+    }
+
     std::string validate() override
     {
         if (error_code != "")
@@ -1755,6 +2532,8 @@ private:
     // is a matching index if m_was_match is true
     std::vector<size_t> m_last;
     std::vector<bool> m_was_match;
+    // Scratch space of evaluate_bitmap(), reused across chunks
+    RowBitmap m_condition_matches{0, 0};
 };
 
 
@@ -1796,6 +2575,17 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override;
 
+    void evaluate_bitmap(RowBitmap& matches) override
+    {
+        m_condition->find_all_bitmap(matches);
+        matches.invert();
+    }
+
+    bool prefers_bitmap_evaluation() const override
+    {
+        return true;
+    }
+
     std::string validate() override
     {
         if (error_code != "")
@@ -1821,6 +2611,11 @@ public:
         return "not()";
     }
 
+    bool describe_is_exact() const override
+    {
+        return m_condition && m_condition->describe_expression_is_exact();
+    }
+
 
     std::unique_ptr<ParentNode> clone(QueryNodeHandoverPatches* patches) const override
     {
@@ -2031,6 +2826,11 @@ public:
     {
         return this->describe_column(m_origin_column) + " " + describe_condition() + " " + metrics::print_value(m_target_row.get_index());
     }
+
+    bool describe_is_exact() const override
+    {
+        return describe_column_is_exact(m_origin_column) && m_target_row.is_attached();
+    }
     virtual std::string describe_condition() const override
     {
         return "links to";
@@ -18,8 +18,11 @@
 
 #include "string_data.hpp"
 
+#include <cstring>
 #include <vector>
 
+#include <realm/impl/substring_search.hpp>
+
 using namespace realm;
 
 namespace {
@@ -127,3 +130,14 @@ bool StringData::matchlike_ins(const StringData& text, const StringData& pattern
 {
     return ::matchlike<true>(text, pattern_upper, &pattern_lower);
 }
+
+size_t StringData::find(StringData needle) const noexcept
+{
+    size_t n = needle.size();
+    if (n == 0)
+        return 0;
+    const char* d = needle.data();
+    return _impl::search_first_last(m_data, m_size, n, d[0], d[0], d[n - 1], d[n - 1], [=](const char* p) {
+        return std::memcmp(p, d, n) == 0;
+    });
+}
@@ -28,7 +28,9 @@
 #include <cfloat>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <ostream>
 #include <string>
 
@@ -137,6 +139,12 @@ public:
     bool ends_with(StringData) const noexcept;
     bool contains(StringData) const noexcept;
     bool contains(StringData d, const std::array<uint8_t, 256> &charmap) const noexcept;
+
+    /// Returns the position of the first occurrence of \a needle, or size()
+    /// if there is none. An empty needle is found at position 0. Vectorized
+    /// where SSE2 is available, which makes it the fastest way to test for a
+    /// substring unless the needle is long enough for Boyer-Moore skipping.
+    size_t find(StringData needle) const noexcept;
     
     // Wildcard matching ('?' for single char, '*' for zero or more chars)
     // case insensitive version in unicode.hpp
@@ -156,6 +164,10 @@ public:
 
     explicit operator bool() const noexcept;
 
+    /// FNV-1a hash of the referenced bytes. The null reference hashes like
+    /// the empty string.
+    size_t hash() const noexcept;
+
 private:
     const char* m_data;
     size_t m_size;
@@ -374,6 +386,28 @@ inline StringData::operator bool() const noexcept
     return !is_null();
 }
 
+inline size_t StringData::hash() const noexcept
+{
+    uint_fast64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < m_size; ++i) {
+        h ^= static_cast<unsigned char>(m_data[i]);
+        h *= 1099511628211ULL;
+    }
+    return size_t(h);
+}
+
 } // namespace realm
 
+namespace std {
+
+template <>
+struct hash<::realm::StringData> {
+    size_t operator()(const ::realm::StringData& str) const noexcept
+    {
+        return str.hash();
+    }
+};
+
+} // namespace std
+
 #endif // REALM_STRING_HPP
@@ -1837,6 +1837,153 @@ void Table::remove_search_index(size_t col_ndx)
 }
 
 
+bool Table::has_ngram_index(size_t col_ndx) const noexcept
+{
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        return false;
+    if (get_real_column_type(col_ndx) != col_type_String)
+        return false;
+    return get_column_string(col_ndx).has_ngram_index();
+}
+
+
+void Table::add_ngram_index(size_t col_ndx)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        throw LogicError(LogicError::column_index_out_of_range);
+    if (REALM_UNLIKELY(get_real_column_type(col_ndx) != col_type_String))
+        throw LogicError(LogicError::illegal_combination);
+
+    get_column_string(col_ndx).add_ngram_index(); // Throws
+}
+
+
+void Table::remove_ngram_index(size_t col_ndx) noexcept
+{
+    if (has_ngram_index(col_ndx))
+        get_column_string(col_ndx).remove_ngram_index();
+}
+
+
+bool Table::has_range_index(size_t col_ndx) const noexcept
+{
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        return false;
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+            if (get_column_base(col_ndx).is_nullable())
+                return get_column_int_null(col_ndx).has_range_index();
+            return get_column(col_ndx).has_range_index();
+        case col_type_Timestamp:
+            return get_column_timestamp(col_ndx).has_range_index();
+        case col_type_Float:
+            return get_column_float(col_ndx).has_range_index();
+        case col_type_Double:
+            return get_column_double(col_ndx).has_range_index();
+        default:
+            return false;
+    }
+}
+
+
+void Table::add_range_index(size_t col_ndx)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        throw LogicError(LogicError::column_index_out_of_range);
+
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+            if (get_column_base(col_ndx).is_nullable())
+                get_column_int_null(col_ndx).add_range_index(); // Throws
+            else
+                get_column(col_ndx).add_range_index(); // Throws
+            return;
+        case col_type_Timestamp:
+            get_column_timestamp(col_ndx).add_range_index(); // Throws
+            return;
+        case col_type_Float:
+            get_column_float(col_ndx).add_range_index(); // Throws
+            return;
+        case col_type_Double:
+            get_column_double(col_ndx).add_range_index(); // Throws
+            return;
+        default:
+            throw LogicError(LogicError::illegal_combination);
+    }
+}
+
+
+void Table::remove_range_index(size_t col_ndx) noexcept
+{
+    if (!has_range_index(col_ndx))
+        return;
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+            if (get_column_base(col_ndx).is_nullable())
+                get_column_int_null(col_ndx).remove_range_index();
+            else
+                get_column(col_ndx).remove_range_index();
+            return;
+        case col_type_Timestamp:
+            get_column_timestamp(col_ndx).remove_range_index();
+            return;
+        case col_type_Float:
+            get_column_float(col_ndx).remove_range_index();
+            return;
+        case col_type_Double:
+            get_column_double(col_ndx).remove_range_index();
+            return;
+        default:
+            return;
+    }
+}
+
+
+bool Table::has_composite_index(const std::vector<size_t>& col_ndxs) const noexcept
+{
+    for (const auto& index : m_composite_indexes) {
+        if (index->get_columns() == col_ndxs)
+            return true;
+    }
+    return false;
+}
+
+
+void Table::add_composite_index(const std::vector<size_t>& col_ndxs)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndxs.empty()))
+        throw LogicError(LogicError::illegal_combination);
+    for (size_t i = 0; i < col_ndxs.size(); ++i) {
+        size_t col_ndx = col_ndxs[i];
+        if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+            throw LogicError(LogicError::column_index_out_of_range);
+        DataType type = get_column_type(col_ndx);
+        if (REALM_UNLIKELY(type != type_Int && type != type_Bool && type != type_String && type != type_Timestamp))
+            throw LogicError(LogicError::illegal_combination);
+        if (REALM_UNLIKELY(std::find(col_ndxs.begin(), col_ndxs.begin() + i, col_ndx) != col_ndxs.begin() + i))
+            throw LogicError(LogicError::illegal_combination);
+    }
+
+    if (!has_composite_index(col_ndxs))
+        m_composite_indexes.emplace_back(new CompositeIndex(col_ndxs)); // Throws
+}
+
+
+void Table::remove_composite_index(const std::vector<size_t>& col_ndxs) noexcept
+{
+    auto it = std::find_if(m_composite_indexes.begin(), m_composite_indexes.end(),
+                           [&](const auto& index) { return index->get_columns() == col_ndxs; });
+    if (it != m_composite_indexes.end())
+        m_composite_indexes.erase(it);
+}
+
+
 void Table::_add_search_index(size_t col_ndx)
 {
     ColumnBase& col = get_column_base(col_ndx);
@@ -4864,6 +5011,9 @@ void Table::optimize(bool enforce)
         ColumnType type_i = get_real_column_type(i);
         if (type_i == col_type_String) {
             StringColumn* column_i = &get_column_string(i);
+            // Enumeration would replace the column accessor that owns the n-gram index
+            if (column_i->has_ngram_index())
+                continue;
 
             ref_type ref, keys_ref;
             bool res = column_i->auto_enumerate(keys_ref, ref, enforce);
@@ -6101,6 +6251,8 @@ void Table::adj_insert_column(size_t col_ndx)
         REALM_ASSERT_3(col_ndx, <=, m_cols.size());
         m_cols.insert(m_cols.begin() + col_ndx, nullptr); // Throws
     }
+    for (const auto& index : m_composite_indexes)
+        index->adj_insert_column(col_ndx);
 }
 
 
@@ -6118,6 +6270,9 @@ void Table::adj_erase_column(size_t col_ndx) noexcept
             delete col;
         m_cols.erase(m_cols.begin() + col_ndx);
     }
+    auto is_dropped = [&](const std::unique_ptr<CompositeIndex>& index) { return !index->adj_erase_column(col_ndx); };
+    m_composite_indexes.erase(std::remove_if(m_composite_indexes.begin(), m_composite_indexes.end(), is_dropped),
+                              m_composite_indexes.end());
 }
 
 void Table::adj_move_column(size_t from, size_t to) noexcept
@@ -6145,6 +6300,8 @@ void Table::adj_move_column(size_t from, size_t to) noexcept
         }
         std::rotate(first, new_first, last);
     }
+    for (const auto& index : m_composite_indexes)
+        index->adj_move_column(from, to);
 }
 
 
@@ -36,6 +36,7 @@
 #include <realm/mixed.hpp>
 #include <realm/query.hpp>
 #include <realm/column.hpp>
+#include <realm/index_composite.hpp>
 
 namespace realm {
 
@@ -247,6 +248,83 @@ public:
 
     //@}
 
+    //@{
+
+    /// add_ngram_index() equips a string column with an index of the trigrams
+    /// of its values (see NGramIndex), which contains(), begins_with(),
+    /// ends_with() and like() conditions use to narrow down the rows they have
+    /// to test. It has no effect if the column already has one.
+    ///
+    /// Unlike a search index, the n-gram index is not stored in the Realm file
+    /// and is not replicated. It belongs to the column accessor of this table
+    /// accessor, and is built on the first query that uses it after each
+    /// change to the table. It therefore pays off for tables that are queried
+    /// more often than they are modified.
+    ///
+    /// Only columns of type String that have not been optimized into
+    /// enumerations (see optimize()) can have an n-gram index. optimize()
+    /// leaves columns that have one alone.
+    ///
+    /// has_ngram_index() returns false if the table accessor is detached or
+    /// the specified index is out of range.
+
+    bool has_ngram_index(size_t column_ndx) const noexcept;
+    void add_ngram_index(size_t column_ndx);
+    void remove_ngram_index(size_t column_ndx) noexcept;
+
+    //@}
+
+    //@{
+
+    /// add_range_index() equips an integer, Timestamp, float or double column
+    /// with an index of its values in ascending order (see RangeIndex), which
+    /// equal(), greater(), greater_equal(), less(), less_equal() and between()
+    /// conditions use to find the matching rows without scanning the column.
+    /// Sorting a view by the column alone, or making it distinct on the
+    /// column, takes the order of the rows from the index as well. It has no
+    /// effect if the column already has one. Unlike the search index, it is
+    /// available for float and double columns.
+    ///
+    /// Like the n-gram index (see add_ngram_index()), the range index is not
+    /// stored in the Realm file and is not replicated, but belongs to the
+    /// column accessor and is built on the first query that uses it after each
+    /// change to the table.
+    ///
+    /// has_range_index() returns false if the table accessor is detached or
+    /// the specified index is out of range.
+
+    bool has_range_index(size_t column_ndx) const noexcept;
+    void add_range_index(size_t column_ndx);
+    void remove_range_index(size_t column_ndx) noexcept;
+
+    //@}
+
+    //@{
+
+    /// add_composite_index() equips the table with an index over the
+    /// specified columns, in that order (see CompositeIndex). A query whose
+    /// top level conditions compare the first N of those columns to a value
+    /// with equal(), and optionally the next one with greater(), less(),
+    /// between() or similar, finds all rows that satisfy those conditions with
+    /// a single lookup in the index. At least one of the conditions on an int
+    /// or Timestamp column must be covered by the index for it to be used. It
+    /// has no effect if the table already has an index over the same columns.
+    ///
+    /// The columns must be distinct and of type Int, Bool, String or
+    /// Timestamp. An index stays attached to its columns when other columns
+    /// are inserted, removed or moved, and is dropped along with any of them.
+    ///
+    /// Like the n-gram index (see add_ngram_index()), the composite index is
+    /// not stored in the Realm file and is not replicated, but belongs to this
+    /// table accessor and is built on the first query that uses it after each
+    /// change to the table.
+
+    bool has_composite_index(const std::vector<size_t>& column_ndxs) const noexcept;
+    void add_composite_index(const std::vector<size_t>& column_ndxs);
+    void remove_composite_index(const std::vector<size_t>& column_ndxs) noexcept;
+
+    //@}
+
     //@{
     /// Get the dynamic type descriptor for this table.
     ///
@@ -1025,6 +1103,9 @@ private:
     typedef std::vector<ColumnBase*> column_accessors;
     column_accessors m_cols;
 
+    // See add_composite_index()
+    std::vector<std::unique_ptr<CompositeIndex>> m_composite_indexes;
+
     mutable std::atomic<size_t> m_ref_count;
 
     // If this table is a root table (has independent descriptor),
@@ -1489,6 +1570,9 @@ private:
     void adj_erase_column(size_t col_ndx) noexcept;
     void adj_move_column(size_t col_ndx_1, size_t col_ndx_2) noexcept;
 
+    // Used by ParentNode::init_composite_index()
+    const std::vector<std::unique_ptr<CompositeIndex>>& get_composite_indexes() const noexcept;
+
     bool is_marked() const noexcept;
     void mark() noexcept;
     void unmark() noexcept;
@@ -1614,6 +1698,11 @@ protected:
 // Implementation:
 
 
+inline const std::vector<std::unique_ptr<CompositeIndex>>& Table::get_composite_indexes() const noexcept
+{
+    return m_composite_indexes;
+}
+
 inline uint_fast64_t Table::get_version_counter() const noexcept
 {
     return m_version;
@@ -100,6 +100,12 @@ size_t sequence_length(char lead);
 // Return bool(string1 < string2)
 bool utf8_compare(StringData string1, StringData string2);
 
+// Return a non-zero key for a unicode character, such that with the
+// STRING_COMPARE_CORE and STRING_COMPARE_CORE_SIMILAR methods, utf8_compare()
+// orders valid strings like the sequences of the keys of their characters.
+// Meaningless with the other methods.
+uint32_t utf8_collation_key(uint32_t unicode);
+
 // Return unicode value of character.
 uint32_t utf8value(const char* character);
 
@@ -154,6 +160,12 @@ size_t search_case_fold(StringData haystack, const char* needle_upper, const cha
 /// needle was not found.
 bool contains_ins(StringData haystack, const char* needle_upper, const char* needle_lower, size_t needle_size, const std::array<uint8_t, 256> &charmap);
 
+/// Same as search_case_fold(), but requires \a needle_upper and \a
+/// needle_lower to be pure ASCII. A byte-wise comparison is then exact, and
+/// the search is vectorized like StringData::find().
+size_t search_case_fold_ascii(StringData haystack, const char* needle_upper, const char* needle_lower,
+                              size_t needle_size) noexcept;
+
 /// Case insensitive wildcard matching ('?' for single char, '*' for zero or more chars)
 bool string_like_ins(StringData text, StringData pattern) noexcept;
 bool string_like_ins(StringData text, StringData upper, StringData lower) noexcept;
@@ -19,7 +19,15 @@
 #include <realm/views.hpp>
 
 #include <realm/column_link.hpp>
+#include <realm/column_string.hpp>
+#include <realm/column_string_enum.hpp>
+#include <realm/column_timestamp.hpp>
 #include <realm/table.hpp>
+#include <realm/unicode.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <typeinfo>
 
 using namespace realm;
 
@@ -28,9 +36,276 @@ struct IndexPair {
     size_t index_in_column;
     size_t index_in_view;
 };
+
+// Sorting by the ranks of a range index visits the rank of every row of the
+// table, so it is only used for views that hold at least this fraction of them
+const size_t index_sort_min_ratio = 8;
+
+template <class ColType>
+const std::vector<size_t>* get_ranks(const ColumnBase* column, uint_fast64_t version, size_t& num_ranks)
+{
+    auto col = dynamic_cast<const ColType*>(column);
+    if (!col)
+        return nullptr;
+    auto index = col->get_range_index();
+    if (!index)
+        return nullptr;
+    index->refresh(*col, version);
+    return &index->get_ranks(num_ranks);
+}
+
+void restore_view_order(std::vector<IndexPair>& v)
+{
+    auto by_view = [](const IndexPair& a, const IndexPair& b) { return a.index_in_view < b.index_in_view; };
+    if (!std::is_sorted(v.begin(), v.end(), by_view))
+        std::sort(v.begin(), v.end(), by_view);
+}
+
+// A stable counting sort by rank, which orders the rows exactly like the
+// comparison sort, nulls being the smallest values
+void sort_by_ranks(std::vector<IndexPair>& v, const std::vector<size_t>& ranks, size_t num_ranks, bool ascending)
+{
+    restore_view_order(v);
+    auto slot = [&](const IndexPair& p) {
+        size_t rank = ranks[p.index_in_column];
+        return ascending ? rank : num_ranks - 1 - rank;
+    };
+    std::vector<size_t> offsets(num_ranks + 1, 0);
+    for (const IndexPair& p : v)
+        ++offsets[slot(p) + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<IndexPair> sorted(v.size());
+    for (const IndexPair& p : v)
+        sorted[offsets[slot(p)]++] = p;
+    v.swap(sorted);
+}
+
+// Keeps the first row of each rank, in view order
+void distinct_by_ranks(std::vector<IndexPair>& v, const std::vector<size_t>& ranks, size_t num_ranks)
+{
+    restore_view_order(v);
+    std::vector<bool> seen(num_ranks, false);
+    v.erase(std::remove_if(v.begin(), v.end(),
+                           [&](const IndexPair& p) {
+                               size_t rank = ranks[p.index_in_column];
+                               if (seen[rank])
+                                   return true;
+                               seen[rank] = true;
+                               return false;
+                           }),
+            v.end());
+}
+
+// Number of characters of a string that go into its sort key
+const size_t string_key_chars = 8;
+
+// SortKeys extracts, for each row to be sorted, a sequence of 64-bit words from
+// the values of the leading columns of the sort, such that comparing the words
+// of two rows in order agrees with comparing their values: nulls first, then
+// the values in ascending order, or the reverse for a descending column.
+// Comparing the keys of a contiguous buffer avoids the virtual calls and
+// B+-tree lookups that comparing values costs in every step of the sort.
+//
+// Keying stops at a column that is reached over links or has an unsupported
+// type. A string column contributes the collation keys of its first
+// characters only, so it is the last column keyed, and rows with equal keys
+// still have to be compared by value.
+class SortKeys {
+public:
+    // Returns the number of leading columns that were keyed, which is zero if
+    // the first one cannot be
+    template <class Columns>
+    size_t build(const Columns& columns, const std::vector<IndexPair>& v);
+
+    bool is_exact() const noexcept
+    {
+        return m_exact;
+    }
+
+    // Compares the keys of the rows at the specified positions in the vector
+    // passed to build()
+    int compare(size_t i, size_t j) const noexcept
+    {
+        const uint64_t* a = &m_words[i * m_width];
+        const uint64_t* b = &m_words[j * m_width];
+        for (size_t k = 0; k < m_width; ++k) {
+            if (a[k] != b[k])
+                return a[k] < b[k] ? -1 : 1;
+        }
+        return 0;
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    size_t m_width = 0;
+    bool m_exact = true;
+
+    static size_t get_width(const ColumnBase& column);
+
+    template <class F>
+    void fill(size_t offset, size_t width, bool ascending, const std::vector<IndexPair>& v, F write);
+    void fill(size_t offset, size_t width, bool ascending, const ColumnBase& column, const std::vector<IndexPair>& v);
+
+    static uint64_t int_key(int64_t value) noexcept
+    {
+        // Flipping the sign bit makes the unsigned representation sort like the signed value
+        return uint64_t(value) ^ (uint64_t(1) << 63);
+    }
+
+    static uint64_t double_key(double value) noexcept
+    {
+        if (value == 0)
+            value = 0; // -0.0 compares equal to 0.0
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        return bits >> 63 ? ~bits : bits | (uint64_t(1) << 63);
+    }
+};
+
+size_t SortKeys::get_width(const ColumnBase& column)
+{
+    const std::type_info& type = typeid(column);
+    if (type == typeid(IntegerColumn))
+        return 1;
+    if (type == typeid(IntNullColumn) || type == typeid(FloatColumn) || type == typeid(DoubleColumn))
+        return 2; // Null flag and value
+    if (type == typeid(TimestampColumn))
+        return 3; // Null flag, seconds and nanoseconds
+    if (type == typeid(StringColumn) || type == typeid(StringEnumColumn)) {
+        // Other methods do not compare strings character by character
+        if (string_compare_method != STRING_COMPARE_CORE && string_compare_method != STRING_COMPARE_CORE_SIMILAR)
+            return 0;
+        return 1 + string_key_chars / 2; // Null flag and two characters per word
+    }
+    return 0;
+}
+
+template <class Columns>
+size_t SortKeys::build(const Columns& columns, const std::vector<IndexPair>& v)
+{
+    m_width = 0;
+    m_exact = true;
+    size_t num_keyed = 0;
+    for (auto& col : columns) {
+        if (!col.translated_row.empty())
+            break;
+        size_t width = get_width(*col.column);
+        if (width == 0)
+            break;
+        m_width += width;
+        ++num_keyed;
+        if (typeid(*col.column) == typeid(StringColumn) || typeid(*col.column) == typeid(StringEnumColumn)) {
+            m_exact = false;
+            break;
+        }
+    }
+    if (num_keyed < columns.size())
+        m_exact = false;
+    if (num_keyed == 0)
+        return 0;
+
+    m_words.assign(v.size() * m_width, 0); // Throws
+    size_t offset = 0;
+    for (size_t i = 0; i < num_keyed; ++i) {
+        size_t width = get_width(*columns[i].column);
+        fill(offset, width, columns[i].ascending, *columns[i].column, v);
+        offset += width;
+    }
+    return num_keyed;
+}
+
+template <class F>
+void SortKeys::fill(size_t offset, size_t width, bool ascending, const std::vector<IndexPair>& v, F write)
+{
+    for (size_t i = 0; i < v.size(); ++i) {
+        uint64_t* words = &m_words[i * m_width + offset];
+        write(v[i].index_in_column, words);
+        if (!ascending) {
+            for (size_t k = 0; k < width; ++k)
+                words[k] = ~words[k];
+        }
+    }
+}
+
+void SortKeys::fill(size_t offset, size_t width, bool ascending, const ColumnBase& column,
+                    const std::vector<IndexPair>& v)
+{
+    const std::type_info& type = typeid(column);
+    if (type == typeid(IntegerColumn)) {
+        auto& col = static_cast<const IntegerColumn&>(column);
+        fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) { words[0] = int_key(col.get(row)); });
+    }
+    else if (type == typeid(IntNullColumn)) {
+        auto& col = static_cast<const IntNullColumn&>(column);
+        fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) {
+            util::Optional<int64_t> value = col.get(row);
+            if (value) {
+                words[0] = 1;
+                words[1] = int_key(*value);
+            }
+        });
+    }
+    else if (type == typeid(FloatColumn)) {
+        auto& col = static_cast<const FloatColumn&>(column);
+        fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) {
+            if (!col.is_null(row)) {
+                words[0] = 1;
+                words[1] = double_key(col.get(row));
+            }
+        });
+    }
+    else if (type == typeid(DoubleColumn)) {
+        auto& col = static_cast<const DoubleColumn&>(column);
+        fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) {
+            if (!col.is_null(row)) {
+                words[0] = 1;
+                words[1] = double_key(col.get(row));
+            }
+        });
+    }
+    else if (type == typeid(TimestampColumn)) {
+        auto& col = static_cast<const TimestampColumn&>(column);
+        fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) {
+            Timestamp value = col.get(row);
+            if (!value.is_null()) {
+                words[0] = 1;
+                words[1] = int_key(value.get_seconds());
+                words[2] = int_key(value.get_nanoseconds());
+            }
+        });
+    }
+    else {
+        auto write = [&](StringData value, uint64_t* words) {
+            if (value.is_null())
+                return;
+            words[0] = 1;
+            // Character keys are never zero, so a string sorts before the
+            // strings it is a prefix of
+            const char* p = value.data();
+            const char* end = p + value.size();
+            for (size_t k = 0; k < string_key_chars && p != end; ++k) {
+                size_t len = sequence_length(*p);
+                if (size_t(end - p) < len)
+                    break; // Invalid UTF-8
+                words[1 + k / 2] |= uint64_t(utf8_collation_key(utf8value(p))) << (k % 2 ? 0 : 32);
+                p += len;
+            }
+        };
+        if (type == typeid(StringColumn)) {
+            auto& col = static_cast<const StringColumn&>(column);
+            fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) { write(col.get(row), words); });
+        }
+        else {
+            auto& col = static_cast<const StringEnumColumn&>(column);
+            fill(offset, width, ascending, v, [&](size_t row, uint64_t* words) { write(col.get(row), words); });
+        }
+    }
+}
+
 } // anonymous namespace
 
 CommonDescriptor::CommonDescriptor(Table const& table, std::vector<std::vector<size_t>> column_indices)
+    : m_table(&table)
 {
     if (table.is_degenerate()) {
         // We need access to the column acessors and that's not available in a
@@ -104,6 +379,11 @@ public:
 
     bool operator()(IndexPair i, IndexPair j, bool total_ordering = true) const;
 
+    // Sort the rows by their sort keys (see SortKeys), resorting to operator()
+    // only for rows whose keys are equal. Returns false, leaving the rows
+    // untouched, if not even the first column can be keyed.
+    bool sort_by_keys(std::vector<IndexPair>& v) const;
+
     bool has_links() const
     {
         return std::any_of(m_columns.begin(), m_columns.end(),
@@ -181,6 +461,23 @@ std::vector<bool> SortDescriptor::export_order() const
     return m_ascending;
 }
 
+const std::vector<size_t>* CommonDescriptor::get_index_ranks(size_t& num_ranks) const
+{
+    if (m_columns.size() != 1 || m_columns[0].size() != 1)
+        return nullptr;
+    const ColumnBase* column = m_columns[0][0];
+    uint_fast64_t version = m_table->get_version_counter();
+    if (auto ranks = get_ranks<IntegerColumn>(column, version, num_ranks))
+        return ranks;
+    if (auto ranks = get_ranks<IntNullColumn>(column, version, num_ranks))
+        return ranks;
+    if (auto ranks = get_ranks<TimestampColumn>(column, version, num_ranks))
+        return ranks;
+    if (auto ranks = get_ranks<FloatColumn>(column, version, num_ranks))
+        return ranks;
+    return get_ranks<DoubleColumn>(column, version, num_ranks);
+}
+
 CommonDescriptor::Sorter CommonDescriptor::sorter(IntegerColumn const& row_indexes) const
 {
     REALM_ASSERT(!m_columns.empty());
@@ -224,6 +521,30 @@ bool SortDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
     return total_ordering ? i.index_in_view < j.index_in_view : 0;
 }
 
+bool SortDescriptor::Sorter::sort_by_keys(std::vector<IndexPair>& v) const
+{
+    SortKeys keys;
+    if (keys.build(m_columns, v) == 0)
+        return false;
+
+    // Sort positions rather than the rows, so that the keys stay in place
+    std::vector<size_t> order(v.size());
+    std::iota(order.begin(), order.end(), 0);
+    bool exact = keys.is_exact();
+    std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+        if (int c = keys.compare(i, j))
+            return c < 0;
+        return exact ? v[i].index_in_view < v[j].index_in_view : (*this)(v[i], v[j]);
+    });
+
+    std::vector<IndexPair> sorted;
+    sorted.reserve(v.size());
+    for (size_t i : order)
+        sorted.push_back(v[i]);
+    v.swap(sorted);
+    return true;
+}
+
 DescriptorOrdering::DescriptorOrdering(const DescriptorOrdering& other)
 {
     for (const auto& d : other.m_descriptors) {
@@ -363,11 +684,23 @@ void RowIndexes::do_sort(const DescriptorOrdering& ordering) {
     for (int desc_ndx = 0; desc_ndx < num_descriptors; ++desc_ndx) {
         const CommonDescriptor* common_descr = ordering[desc_ndx];
 
-        if (const auto* sort_descr = dynamic_cast<const SortDescriptor*>(common_descr)) {
+        // A range index on the only column gives the order of the rows
+        // without comparing their values
+        size_t num_ranks = 0;
+        const std::vector<size_t>* ranks = common_descr->get_index_ranks(num_ranks);
+        if (ranks && v.size() < ranks->size() / index_sort_min_ratio)
+            ranks = nullptr;
 
-            SortDescriptor::Sorter sort_predicate = sort_descr->sorter(m_row_indexes);
+        if (const auto* sort_descr = dynamic_cast<const SortDescriptor*>(common_descr)) {
 
-            std::sort(v.begin(), v.end(), std::ref(sort_predicate));
+            if (ranks) {
+                sort_by_ranks(v, *ranks, num_ranks, sort_descr->is_ascending(0));
+            }
+            else {
+                SortDescriptor::Sorter sort_predicate = sort_descr->sorter(m_row_indexes);
+                if (!sort_predicate.sort_by_keys(v))
+                    std::sort(v.begin(), v.end(), std::ref(sort_predicate));
+            }
 
             bool is_last_ordering = desc_ndx == num_descriptors - 1;
             // not doing this on the last step is an optimisation
@@ -381,6 +714,10 @@ void RowIndexes::do_sort(const DescriptorOrdering& ordering) {
                 }
             }
         }
+        else if (ranks) { // distinct descriptor
+            // Leaves the rows in their original order
+            distinct_by_ranks(v, *ranks, num_ranks);
+        }
         else { // distinct descriptor
             auto distinct_predicate = common_descr->sorter(m_row_indexes);
 
@@ -392,7 +729,8 @@ void RowIndexes::do_sort(const DescriptorOrdering& ordering) {
             }
 
             // Sort by the columns to distinct on
-            std::sort(v.begin(), v.end(), std::ref(distinct_predicate));
+            if (!distinct_predicate.sort_by_keys(v))
+                std::sort(v.begin(), v.end(), std::ref(distinct_predicate));
 
             // Remove all duplicates
             v.erase(std::unique(v.begin(), v.end(),
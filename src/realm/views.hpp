@@ -63,6 +63,11 @@ public:
     class Sorter;
     virtual Sorter sorter(IntegerColumn const& row_indexes) const;
 
+    // If this descriptor consists of a single column, not reached over links,
+    // which has a range index, returns the ranks of the rows of the table by
+    // that column (see RangeIndex::get_ranks()). Returns null otherwise.
+    const std::vector<size_t>* get_index_ranks(size_t& num_ranks) const;
+
     // handover support
     std::vector<std::vector<size_t>> export_column_indices() const;
     virtual std::vector<bool> export_order() const
@@ -72,6 +77,7 @@ public:
 
 protected:
     std::vector<std::vector<const ColumnBase*>> m_columns;
+    const Table* m_table = nullptr;
 };
 
 class SortDescriptor : public CommonDescriptor {
@@ -88,6 +94,11 @@ public:
 
     void merge_with(SortDescriptor&& other);
 
+    bool is_ascending(size_t ndx) const
+    {
+        return m_ascending[ndx];
+    }
+
     Sorter sorter(IntegerColumn const& row_indexes) const override;
 
     // handover support
@@ -694,6 +694,52 @@ struct BenchmarkQueryInsensitiveStringIndexed : BenchmarkQueryInsensitiveString
     }
 };
 
+struct BenchmarkQueryContainsInsensitiveString : BenchmarkQueryInsensitiveString {
+    const char* name() const
+    {
+        return "QueryContainsInsensitiveString";
+    }
+
+    void before_each(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("StringOnly");
+        size_t target_row = rand() % table->size();
+        std::string target_str = table->get_string(0, target_row);
+        // A short needle from the middle of the string, as typed into a search field
+        size_t needle_size = std::min<size_t>(target_str.size(), 3 + rand() % 6);
+        size_t pos = (target_str.size() - needle_size) / 2;
+        needle = shuffle_case(target_str.substr(pos, needle_size));
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("StringOnly");
+        StringData str(needle);
+        Query q = table->where().contains(0, str, false);
+        TableView res = q.find_all();
+        successful = res.size() > 0;
+    }
+};
+
+struct BenchmarkQueryContainsString : BenchmarkQueryContainsInsensitiveString {
+    const char* name() const
+    {
+        return "QueryContainsString";
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("StringOnly");
+        StringData str(needle);
+        Query q = table->where().contains(0, str, true);
+        TableView res = q.find_all();
+        successful = res.size() > 0;
+    }
+};
+
 struct BenchmarkSetLongString : BenchmarkWithLongStrings {
     const char* name() const
     {
@@ -748,6 +794,106 @@ struct BenchmarkQueryNot : Benchmark {
     }
 };
 
+// Membership tests against a list of values, as a single in() condition and as the
+// equivalent chain of Or()'ed equal() conditions.
+const size_t num_in_values = 50;
+
+struct BenchmarkQueryIntIn : BenchmarkWithInts {
+    std::vector<int64_t> values;
+
+    const char* name() const
+    {
+        return "QueryIntIn";
+    }
+
+    void before_all(SharedGroup& group)
+    {
+        BenchmarkWithInts::before_all(group);
+        ReadTransaction tr(group);
+        ConstTableRef t = tr.get_table("IntOnly");
+        for (size_t i = 0; i < num_in_values; ++i)
+            values.push_back(t->get_int(0, i * 7));
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("IntOnly");
+        TableView results = table->where().in(0, values).find_all();
+        static_cast<void>(results);
+    }
+};
+
+struct BenchmarkQueryIntInOrChain : BenchmarkQueryIntIn {
+    const char* name() const
+    {
+        return "QueryIntInOrChain";
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("IntOnly");
+        Query q = table->where();
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i)
+                q.Or();
+            q.equal(0, values[i]);
+        }
+        TableView results = q.find_all();
+        static_cast<void>(results);
+    }
+};
+
+struct BenchmarkQueryStringIn : BenchmarkWithStrings {
+    std::vector<std::string> strings;
+    std::vector<StringData> values;
+
+    const char* name() const
+    {
+        return "QueryStringIn";
+    }
+
+    void before_all(SharedGroup& group)
+    {
+        BenchmarkWithStrings::before_all(group);
+        ReadTransaction tr(group);
+        ConstTableRef t = tr.get_table("StringOnly");
+        for (size_t i = 0; i < num_in_values; ++i)
+            strings.push_back(t->get_string(0, i * 7));
+        values.assign(strings.begin(), strings.end());
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("StringOnly");
+        TableView results = table->where().in(0, values).find_all();
+        static_cast<void>(results);
+    }
+};
+
+struct BenchmarkQueryStringInOrChain : BenchmarkQueryStringIn {
+    const char* name() const
+    {
+        return "QueryStringInOrChain";
+    }
+
+    void operator()(SharedGroup& group)
+    {
+        ReadTransaction tr(group);
+        ConstTableRef table = tr.get_table("StringOnly");
+        Query q = table->where();
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i)
+                q.Or();
+            q.equal(0, values[i]);
+        }
+        TableView results = q.find_all();
+        static_cast<void>(results);
+    }
+};
+
 struct BenchmarkGetLinkList : Benchmark {
     const char* name() const
     {
@@ -981,6 +1127,10 @@ int benchmark_common_tasks_main()
     BENCH(AddTable);
     BENCH(BenchmarkQuery);
     BENCH(BenchmarkQueryNot);
+    BENCH(BenchmarkQueryIntIn);
+    BENCH(BenchmarkQueryIntInOrChain);
+    BENCH(BenchmarkQueryStringIn);
+    BENCH(BenchmarkQueryStringInOrChain);
     BENCH(BenchmarkSize);
     BENCH(BenchmarkSort);
     BENCH(BenchmarkSortInt);
@@ -1002,6 +1152,8 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkGetLinkList);
     BENCH(BenchmarkQueryInsensitiveString);
     BENCH(BenchmarkQueryInsensitiveStringIndexed);
+    BENCH(BenchmarkQueryContainsInsensitiveString);
+    BENCH(BenchmarkQueryContainsString);
     BENCH(BenchmarkNonInitatorOpen);
 
 #undef BENCH
@@ -25,6 +25,7 @@
 #include <realm/column_string.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/util/to_string.hpp>
+#include <map>
 #include <set>
 #include "test.hpp"
 #include "test_string_types.hpp"
@@ -1917,4 +1918,116 @@ TEST_TYPES(StringIndex_Rover, string_column, nullable_string_column, enum_column
 }
 
 
+// The index of a column with existing rows is built by StringIndex::insert_bulk()
+TEST_TYPES(StringIndex_BulkBuild, string_column, nullable_string_column, enum_column, nullable_enum_column)
+{
+    TEST_TYPE test_resources;
+    typename TEST_TYPE::ColumnTestType& col = test_resources.get_column();
+    Random random(random_int<unsigned long>());
+
+    // Duplicates, strings that are prefixes of each other and strings sharing
+    // a prefix longer than StringIndex::s_max_offset
+    const std::string long_prefix(StringIndex::s_max_offset + 50, 'x');
+    std::vector<std::string> strings = {"", "a", "abc", "abcX", "abcd", "abcde", "John", "Johnny", "Johnathan"};
+    for (int i = 0; i < 5; ++i)
+        strings.push_back(long_prefix + util::to_string(i));
+    strings.push_back(long_prefix);
+
+    // Every third row has the same value, so its row list outgrows a B+-tree leaf
+    const size_t n = 4 * REALM_MAX_BPNODE_SIZE;
+    bool nullable = TEST_TYPE::is_nullable();
+    for (size_t i = 0; i < n; ++i) {
+        if (nullable && i % 11 == 0) {
+            col.add(realm::null());
+        }
+        else if (i % 3 == 0) {
+            std::string str = util::to_string(random.draw_int_max(100000)); // Mostly unique
+            col.add(str);
+        }
+        else if (i % 3 == 1) {
+            col.add("Johnny");
+        }
+        else {
+            col.add(strings[random.draw_int_mod(strings.size())]);
+        }
+    }
+
+    const StringIndex& ndx = *col.create_search_index();
+#ifdef REALM_DEBUG
+    ndx.verify();
+#endif
+
+    ref_type results_ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn results(Allocator::get_default(), results_ref);
+    auto check_all = [&] {
+        // Expected rows of each value, null sorting first
+        std::map<std::pair<bool, std::string>, std::vector<size_t>> expected;
+        for (size_t i = 0; i < col.size(); ++i) {
+            StringData value = col.get(i);
+            expected[std::make_pair(!value.is_null(), std::string(value))].push_back(i);
+        }
+        for (const auto& entry : expected) {
+            StringData value = entry.first.first ? StringData(entry.first.second) : StringData();
+            const std::vector<size_t>& rows = entry.second;
+            results.clear();
+            ndx.find_all(results, value);
+            if (CHECK_EQUAL(results.size(), rows.size())) {
+                for (size_t i = 0; i < rows.size(); ++i)
+                    CHECK_EQUAL(results.get(i), rows[i]);
+            }
+            CHECK_EQUAL(ndx.count(value), rows.size());
+            CHECK_EQUAL(ndx.find_first(value), rows[0]);
+        }
+    };
+    check_all();
+
+    // The built index supports the incremental operations
+    for (size_t i = 0; i < n / 10; ++i) {
+        size_t row = random.draw_int_mod(col.size());
+        switch (random.draw_int_mod(3)) {
+            case 0:
+                col.set(row, strings[random.draw_int_mod(strings.size())]);
+                break;
+            case 1:
+                col.insert(row, strings[random.draw_int_mod(strings.size())]);
+                break;
+            case 2:
+                col.erase(row);
+                break;
+        }
+    }
+#ifdef REALM_DEBUG
+    ndx.verify();
+#endif
+    check_all();
+
+    results.destroy();
+}
+
+
+TEST(StringIndex_BulkBuild_Int)
+{
+    ref_type ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn col(Allocator::get_default(), ref);
+    Random random(random_int<unsigned long>());
+    const size_t n = 3 * REALM_MAX_BPNODE_SIZE;
+
+    for (size_t i = 0; i < n; ++i)
+        col.add(i % 2 ? int64_t(random.draw_int_max(0xffffffffffffffff)) : int64_t(random.draw_int_mod(50)));
+
+    const StringIndex& ndx = *col.create_search_index();
+#ifdef REALM_DEBUG
+    ndx.verify();
+#endif
+    std::map<int64_t, std::vector<size_t>> expected;
+    for (size_t i = 0; i < n; ++i)
+        expected[col.get(i)].push_back(i);
+    for (const auto& entry : expected) {
+        CHECK_EQUAL(ndx.count(entry.first), entry.second.size());
+        CHECK_EQUAL(ndx.find_first(entry.first), entry.second[0]);
+    }
+    col.destroy();
+}
+
+
 #endif // TEST_INDEX_STRING
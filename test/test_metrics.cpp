@@ -896,6 +896,92 @@ TEST(Metrics_TransactionVersions)
 }
 
 
+TEST(Metrics_QueryCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroupOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.enable_query_cache = true;
+    SharedGroup sg(*hist, options);
+    std::shared_ptr<Metrics> metrics = sg.get_metrics();
+    CHECK(metrics);
+    {
+        WriteTransaction wt(sg);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "str");
+        table->add_column(type_Int, "int"); // Same name as the first column
+        table->add_empty_row(100);
+        for (size_t i = 0; i < 100; ++i) {
+            table->set_int(0, i, i % 10);
+            table->set_string(1, i, i % 2 ? "odd" : "even");
+            table->set_int(2, i, i % 7);
+        }
+        // No caching in write transactions
+        CHECK_EQUAL(table->where().equal(0, 3).count(), 10);
+        CHECK_EQUAL(table->where().equal(0, 3).count(), 10);
+        CHECK_EQUAL(metrics->num_query_cache_hits() + metrics->num_query_cache_misses(), 0);
+        wt.commit();
+    }
+
+    const Group& g = sg.begin_read();
+    ConstTableRef table = g.get_table("table");
+    CHECK_EQUAL(table->where().equal(0, 3).count(), 10);
+    CHECK_EQUAL(metrics->num_query_cache_misses(), 1);
+    CHECK_EQUAL(table->where().equal(0, 3).count(), 10);
+    CHECK_EQUAL(metrics->num_query_cache_hits(), 1);
+
+    // Other values, operations and arguments are other results
+    CHECK_EQUAL(table->where().equal(0, 4).count(), 10);
+    CHECK_EQUAL(table->where().equal(0, 3).count(0, 50), 5);
+    CHECK_EQUAL(table->where().equal(1, "odd").count(), 50);
+    CHECK_EQUAL(table->where().equal(1, "odd", false).count(), 50);
+    CHECK_EQUAL(metrics->num_query_cache_hits(), 1);
+    CHECK_EQUAL(metrics->num_query_cache_misses(), 5);
+
+    size_t result_count = 0;
+    CHECK_EQUAL(table->where().equal(1, "odd").sum_int(0, &result_count), 250);
+    CHECK_EQUAL(result_count, 50);
+    result_count = 0;
+    CHECK_EQUAL(table->where().equal(1, "odd").sum_int(0, &result_count), 250);
+    CHECK_EQUAL(result_count, 50);
+
+    ConstTableView tv_1 = table->where().equal(0, 3).Or().equal(0, 5).find_all();
+    ConstTableView tv_2 = table->where().equal(0, 3).Or().equal(0, 5).find_all();
+    CHECK_EQUAL(tv_1.size(), 20);
+    CHECK_EQUAL(tv_2.size(), 20);
+    for (size_t i = 0; i < tv_1.size(); ++i)
+        CHECK_EQUAL(tv_1.get_source_ndx(i), tv_2.get_source_ndx(i));
+    CHECK_EQUAL(metrics->num_query_cache_hits(), 3);
+    CHECK_EQUAL(metrics->num_query_cache_misses(), 7);
+
+    // The description of a condition on a column with an ambiguous name does
+    // not identify the query
+    CHECK_EQUAL(table->where().equal(2, 3).count(), 14);
+    CHECK_EQUAL(table->where().equal(2, 3).count(), 14);
+    CHECK_EQUAL(metrics->num_query_cache_hits() + metrics->num_query_cache_misses(), 10);
+
+    // Results are dropped when moving to a newer snapshot
+    {
+        std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+        SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+        WriteTransaction wt(sg_w);
+        wt.get_table("table")->set_int(0, 0, 3);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg);
+    CHECK_EQUAL(table->where().equal(0, 3).count(), 11);
+    CHECK_EQUAL(metrics->num_query_cache_hits(), 3);
+    CHECK_EQUAL(metrics->num_query_cache_misses(), 8);
+    sg.end_read();
+
+    sg.begin_read();
+    table = g.get_table("table");
+    CHECK_EQUAL(table->where().equal(0, 3).count(), 11);
+    CHECK_EQUAL(metrics->num_query_cache_misses(), 9);
+    sg.end_read();
+}
 
 #endif // REALM_METRICS
 #endif // TEST_METRICS
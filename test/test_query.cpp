@@ -20,6 +20,7 @@
 #ifdef TEST_QUERY
 
 #include <cstdlib> // itoa()
+#include <functional>
 #include <initializer_list>
 #include <limits>
 #include <vector>
@@ -10914,4 +10915,535 @@ TEST_TYPES(Query_Rover, std::true_type, std::false_type)
 }
 
 
+// OR and NOT at the top level of a query make find_all() and count() evaluate the query set-at-a-time. Use enough
+// rows to span several bitmap chunks and compare against the expected rows computed by hand.
+TEST(Query_BitmapEvaluation)
+{
+    Table table;
+    size_t col_int = table.add_column(type_Int, "int");
+    size_t col_null = table.add_column(type_Int, "nullable", true);
+    size_t col_str = table.add_column(type_String, "str");
+
+    const size_t num_rows = 20000;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.set_int(col_int, i, i % 7);
+        if (i % 3)
+            table.set_int(col_null, i, i % 5);
+        table.set_string(col_str, i, i % 11 == 0 ? "eleven" : "other");
+    }
+
+    auto check = [&](Query q, std::function<bool(size_t)> expected) {
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (expected(i))
+                rows.push_back(i);
+        }
+        TableView tv = q.find_all();
+        CHECK_EQUAL(tv.size(), rows.size());
+        for (size_t i = 0; i < rows.size() && i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_source_ndx(i), rows[i]);
+        CHECK_EQUAL(q.count(), rows.size());
+
+        // limit and range are honoured
+        size_t limit = rows.size() / 2;
+        tv = q.find_all(0, size_t(-1), limit);
+        CHECK_EQUAL(tv.size(), limit);
+        CHECK_EQUAL(q.count(0, size_t(-1), limit), limit);
+        if (limit > 0)
+            CHECK_EQUAL(tv.get_source_ndx(limit - 1), rows[limit - 1]);
+        size_t in_range = std::count_if(rows.begin(), rows.end(), [](size_t r) { return r >= 5000 && r < 15000; });
+        CHECK_EQUAL(q.count(5000, 15000), in_range);
+    };
+
+    check(table.where().equal(col_int, 1).Or().equal(col_int, 3).Or().equal(col_str, "eleven"),
+          [](size_t i) { return i % 7 == 1 || i % 7 == 3 || i % 11 == 0; });
+
+    check(table.where().Not().equal(col_int, 2), [](size_t i) { return i % 7 != 2; });
+
+    check(table.where().Not().equal(col_null, 4).equal(col_str, "other"),
+          [](size_t i) { return !(i % 3 && i % 5 == 4) && i % 11 != 0; });
+
+    check(table.where().greater(col_int, 4).group().equal(col_null, 0).Or().equal(col_null, realm::null()).end_group(),
+          [](size_t i) { return i % 7 > 4 && (i % 3 == 0 || i % 5 == 0); });
+
+    check(table.where().Not().group().equal(col_int, 0).Or().equal(col_str, "eleven").end_group(),
+          [](size_t i) { return i % 7 != 0 && i % 11 != 0; });
+}
+
+
+TEST(Query_In)
+{
+    Table table;
+    size_t col_int = table.add_column(type_Int, "int");
+    size_t col_null = table.add_column(type_Int, "int_null", true);
+    size_t col_str = table.add_column(type_String, "str", true);
+    size_t col_ts = table.add_column(type_Timestamp, "ts", true);
+
+    const size_t num_rows = 3000;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.set_int(col_int, i, int64_t(i % 17) - 8);
+        if (i % 5)
+            table.set_int(col_null, i, i % 13);
+        if (i % 4) {
+            std::string str = std::string("s") + util::to_string(i % 9);
+            table.set_string(col_str, i, str);
+        }
+        if (i % 3)
+            table.set_timestamp(col_ts, i, Timestamp(int64_t(i % 11), 0));
+    }
+
+    std::vector<int64_t> ints = {-8, 3, 3, 7, 1000};
+    std::vector<StringData> strings = {"s1", "s5", "s8", "nope", realm::null()};
+    std::vector<Timestamp> timestamps = {Timestamp(2, 0), Timestamp(10, 0), Timestamp(realm::null())};
+
+    auto check = [&](Query in, Query ors) {
+        TableView tv_in = in.find_all();
+        TableView tv_or = ors.find_all();
+        CHECK_EQUAL(tv_in.size(), tv_or.size());
+        for (size_t i = 0; i < tv_in.size() && i < tv_or.size(); ++i)
+            CHECK_EQUAL(tv_in.get_source_ndx(i), tv_or.get_source_ndx(i));
+        CHECK_EQUAL(in.count(), tv_or.size());
+        CHECK_EQUAL(in.count(100, 2000), ors.count(100, 2000));
+        CHECK_EQUAL(in.find(1234), ors.find(1234));
+    };
+
+    auto run = [&] {
+        Query ints_or = table.where().group();
+        for (size_t i = 0; i < ints.size(); ++i) {
+            if (i)
+                ints_or.Or();
+            ints_or.equal(col_int, ints[i]);
+        }
+        ints_or.end_group();
+        check(table.where().in(col_int, ints), ints_or);
+
+        Query nulls_or = table.where().equal(col_null, 0).Or().equal(col_null, 12);
+        check(table.where().in(col_null, std::vector<int64_t>{0, 12}), nulls_or);
+
+        Query strings_or = table.where().group();
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (i)
+                strings_or.Or();
+            strings_or.equal(col_str, strings[i]);
+        }
+        strings_or.end_group();
+        check(table.where().in(col_str, strings), strings_or);
+
+        Query timestamps_or = table.where()
+                                  .equal(col_ts, timestamps[0])
+                                  .Or()
+                                  .equal(col_ts, timestamps[1])
+                                  .Or()
+                                  .equal(col_ts, realm::null());
+        check(table.where().in(col_ts, timestamps), timestamps_or);
+
+        // Combined with other conditions, and under Not()
+        check(table.where().greater(col_int, 0).in(col_str, strings),
+              table.where().greater(col_int, 0).group().equal(col_str, "s1").Or().equal(col_str, "s5").Or()
+                  .equal(col_str, "s8").Or().equal(col_str, realm::null()).end_group());
+        check(table.where().Not().in(col_int, ints), table.where().Not().group().equal(col_int, -8).Or()
+                  .equal(col_int, 3).Or().equal(col_int, 7).end_group());
+
+        // An empty list matches nothing
+        CHECK_EQUAL(table.where().in(col_int, std::vector<int64_t>()).count(), 0);
+        CHECK_EQUAL(table.where().in(col_str, std::vector<StringData>()).count(), 0);
+        CHECK_EQUAL(table.where().in(col_ts, std::vector<Timestamp>()).count(), 0);
+    };
+
+    run();
+    table.add_search_index(col_int);
+    table.add_search_index(col_null);
+    table.add_search_index(col_str);
+    table.add_search_index(col_ts);
+    run();
+    table.optimize(true);
+    run();
+
+    CHECK_LOGIC_ERROR(table.where().in(col_str, ints), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(table.where().in(col_int, strings), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(table.where().in(col_int, timestamps), LogicError::type_mismatch);
+}
+
+
+TEST(Query_ContainsAgainstExpression)
+{
+    // The Contains and ContainsIns nodes search each string with vectorized code, the
+    // expression engine does not, so the two must agree.
+    Table table;
+    table.add_column(type_String, "str", true);
+    const char* words[] = {"foo", "FOO", "fOo bar", "barfoo", "\xc3\xa6f\xc3\xb8O", "o", "", "xxxxxxxxxxxxxxxxxxxxfoo",
+                           "xxxxxxxxxxxxxxxxxxxxFoOxxxxxxxxxxxxxxxxxxx", "fo", "oof", "f o o"};
+    const size_t num_words = sizeof(words) / sizeof(words[0]);
+    table.add_empty_row(300);
+    for (size_t i = 0; i < 300; ++i) {
+        if (i % 13 == 12)
+            continue;
+        std::string s = words[i % num_words];
+        if (i % 7 == 0)
+            s = "padding padding " + s;
+        table.set_string(0, i, s);
+    }
+
+    const char* needles[] = {"foo", "FoO", "o", "\xc3\xa6f", "\xc3\x86F", "xxxxxxxxxxfoo", "oo b", "zzz"};
+    for (const char* needle : needles) {
+        for (bool case_sensitive : {true, false}) {
+            size_t expected = table.column<String>(0).contains(needle, case_sensitive).count();
+            CHECK_EQUAL(table.where().contains(0, needle, case_sensitive).count(), expected);
+        }
+    }
+}
+
+
+TEST(Query_NGramIndex)
+{
+    Table table;
+    table.add_column(type_String, "str", true);
+    table.add_column(type_Int, "int");
+    const char* words[] = {"Hello world", "hello", "yellow", "WORLDWIDE", "\xc3\xa6\xc3\xb8\xc3\xa5 hello", "low",
+                           "lo", "", "the world is yellow", "swirled", "xyzzy", "Help!"};
+    const size_t num_words = sizeof(words) / sizeof(words[0]);
+    auto fill = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (i % 17 == 16)
+                continue;
+            std::string str = words[i % num_words];
+            if (i % 5 == 0)
+                str += " #" + util::to_string(i);
+            table.set_string(0, i, str);
+            table.set_int(1, i, i % 3);
+        }
+    };
+    table.add_empty_row(2000);
+    fill(0, 2000);
+
+    const char* needles[] = {"hello", "HeLLo", "ell", "world", "llow", "wor", "#12", "\xc3\xa6\xc3\xb8",
+                             "\xc3\xb8\xc3\xa5 h", "zzz", "lo", "qqq"};
+    const char* patterns[] = {"*ell*", "h*o", "*wor?d*", "?ell*", "*#1?3", "*", "lo"};
+
+    auto run_all = [&] {
+        std::vector<size_t> counts;
+        for (const char* needle : needles) {
+            for (bool case_sensitive : {true, false}) {
+                counts.push_back(table.where().contains(0, needle, case_sensitive).count());
+                counts.push_back(table.where().begins_with(0, needle, case_sensitive).count());
+                counts.push_back(table.where().ends_with(0, needle, case_sensitive).count());
+                counts.push_back(table.where().equal(1, 1).contains(0, needle, case_sensitive).count());
+                counts.push_back(table.where().Not().contains(0, needle, case_sensitive).count());
+            }
+        }
+        for (const char* pattern : patterns) {
+            for (bool case_sensitive : {true, false})
+                counts.push_back(table.where().like(0, pattern, case_sensitive).count());
+        }
+        // Candidates must not leak outside the requested range
+        counts.push_back(table.where().contains(0, "hello", false).count(100, 1400));
+        counts.push_back(table.where().contains(0, "hello", false).find(777));
+        return counts;
+    };
+
+    std::vector<size_t> expected = run_all();
+    table.add_ngram_index(0);
+    CHECK(table.has_ngram_index(0));
+    CHECK(!table.has_ngram_index(1));
+    CHECK(run_all() == expected);
+
+    // The index is rebuilt after the table changes
+    table.insert_empty_row(3, 500);
+    fill(0, 2500);
+    table.set_string(0, 0, "Mellow yellow");
+    table.move_last_over(10);
+    table.swap_rows(20, 30);
+    table.remove(40);
+    table.clear();
+    table.add_empty_row(1500);
+    fill(0, 1500);
+    table.remove_ngram_index(0);
+    expected = run_all();
+    table.add_ngram_index(0);
+    CHECK(run_all() == expected);
+    table.set_string(0, 1, "a new hello");
+    table.remove(2);
+    std::vector<size_t> after_change = run_all();
+    table.remove_ngram_index(0);
+    CHECK(run_all() == after_change);
+    CHECK(!table.has_ngram_index(0));
+
+    // Columns with an n-gram index are not enumerated
+    table.add_ngram_index(0);
+    table.optimize(true);
+    CHECK(table.has_ngram_index(0));
+    CHECK(run_all() == after_change);
+
+    CHECK_LOGIC_ERROR(table.add_ngram_index(1), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_ngram_index(2), LogicError::column_index_out_of_range);
+}
+
+
+TEST(Query_RangeIndex)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_Int, "int_null", true);
+    table.add_column(type_Timestamp, "ts", true);
+    table.add_column(type_String, "str");
+    auto fill = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int64_t v = int64_t((i * 7919) % 1000) - 500;
+            table.set_int(0, i, v);
+            if (i % 11 == 0)
+                table.set_null(1, i);
+            else
+                table.set_int(1, i, v);
+            if (i % 13 == 0)
+                table.set_null(2, i);
+            else
+                table.set_timestamp(2, i, Timestamp(v / 10, v < 0 ? -int32_t(i % 3) : int32_t(i % 3)));
+        }
+    };
+    table.add_empty_row(3000);
+    fill(0, 3000);
+
+    const int64_t values[] = {-600, -500, -490, -1, 0, 17, 380, 499, 600};
+
+    auto run_all = [&] {
+        std::vector<size_t> results;
+        for (int64_t v : values) {
+            for (size_t col : {0, 1}) {
+                results.push_back(table.where().greater(col, v).count());
+                results.push_back(table.where().greater_equal(col, v).count());
+                results.push_back(table.where().less(col, v).count());
+                results.push_back(table.where().less_equal(col, v).count());
+                results.push_back(table.where().between(col, v, v + 50).count());
+                results.push_back(size_t(table.where().less(col, v).sum_int(0)));
+                results.push_back(table.where().greater(col, v).find(1234));
+                results.push_back(table.where().greater_equal(col, v).count(100, 2500));
+                results.push_back(table.where().less(col, v).Or().equal(0, 3).count());
+                results.push_back(table.where().Not().greater(col, v).count());
+                TableView tv = table.where().less_equal(col, v).greater(1 - col, v - 100).find_all();
+                for (size_t i = 0; i < tv.size(); ++i)
+                    results.push_back(tv.get_source_ndx(i));
+            }
+            Timestamp ts(v / 10, v < 0 ? -1 : 1);
+            results.push_back(table.where().greater(2, ts).count());
+            results.push_back(table.where().greater_equal(2, ts).count());
+            results.push_back(table.where().less(2, ts).count());
+            results.push_back(table.where().less_equal(2, ts).count());
+            results.push_back(table.where().greater(2, ts).less(0, 0).find(100));
+        }
+        return results;
+    };
+
+    std::vector<size_t> expected = run_all();
+    table.add_range_index(0);
+    table.add_range_index(1);
+    table.add_range_index(2);
+    CHECK(table.has_range_index(0));
+    CHECK(table.has_range_index(1));
+    CHECK(table.has_range_index(2));
+    CHECK(!table.has_range_index(3));
+    CHECK(run_all() == expected);
+
+    // The index is rebuilt after the table changes
+    table.insert_empty_row(3, 500);
+    fill(0, 3500);
+    table.set_int(0, 0, 1000);
+    table.set_null(1, 1);
+    table.move_last_over(10);
+    table.swap_rows(20, 30);
+    table.remove(40);
+    std::vector<size_t> after_change = run_all();
+    for (size_t col : {0, 1, 2})
+        table.remove_range_index(col);
+    CHECK(!table.has_range_index(0));
+    CHECK(run_all() == after_change);
+
+    CHECK_LOGIC_ERROR(table.add_range_index(3), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_range_index(4), LogicError::column_index_out_of_range);
+}
+
+
+TEST(Query_RangeIndex_FloatDouble)
+{
+    Table table;
+    table.add_column(type_Float, "float");
+    table.add_column(type_Double, "double_null", true);
+    table.add_column(type_Double, "double");
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    auto fill = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double v = double(int64_t((i * 7919) % 1000) - 500) / 8;
+            if (i % 100 == 1)
+                v = -0.0;
+            table.set_float(0, i, float(v));
+            if (i % 11 == 0)
+                table.set_null(1, i);
+            else
+                table.set_double(1, i, v);
+            table.set_double(2, i, i % 97 == 0 ? nan : v);
+        }
+    };
+    table.add_empty_row(3000);
+    fill(0, 3000);
+
+    const double values[] = {-100, -62.5, -62.375, -0.0, 0.0, 0.125, 2.1, 47.5, 62.375, 100, nan};
+
+    auto run_all = [&] {
+        std::vector<size_t> results;
+        for (double v : values) {
+            results.push_back(table.where().equal(0, float(v)).count());
+            results.push_back(table.where().greater(0, float(v)).count());
+            results.push_back(table.where().less_equal(0, float(v)).find(1000));
+            for (size_t col : {1, 2}) {
+                results.push_back(table.where().equal(col, v).count());
+                results.push_back(table.where().not_equal(col, v).count());
+                results.push_back(table.where().greater(col, v).count());
+                results.push_back(table.where().greater_equal(col, v).count());
+                results.push_back(table.where().less(col, v).count());
+                results.push_back(table.where().less_equal(col, v).count(200, 2800));
+                results.push_back(table.where().between(col, v, v + 5).count());
+                results.push_back(table.where().equal(col, v).Or().equal(0, 3.0f).count());
+                TableView tv = table.where().less(col, v).greater(0, float(v - 20)).find_all();
+                for (size_t i = 0; i < tv.size(); ++i)
+                    results.push_back(tv.get_source_ndx(i));
+            }
+        }
+        results.push_back(table.where().equal(1, null()).count());
+        return results;
+    };
+
+    std::vector<size_t> expected = run_all();
+    for (size_t col : {0, 1, 2})
+        table.add_range_index(col);
+    CHECK(table.has_range_index(0));
+    CHECK(table.has_range_index(1));
+    CHECK(table.has_range_index(2));
+    CHECK(run_all() == expected);
+
+    // The index is rebuilt after the table changes
+    table.insert_empty_row(3, 500);
+    fill(0, 3500);
+    table.set_double(2, 0, -0.0);
+    table.set_null(1, 1);
+    table.move_last_over(10);
+    table.remove(40);
+    std::vector<size_t> after_change = run_all();
+    for (size_t col : {0, 1, 2})
+        table.remove_range_index(col);
+    CHECK(!table.has_range_index(1));
+    CHECK(run_all() == after_change);
+}
+
+
+TEST(Query_CompositeIndex)
+{
+    Table table;
+    table.add_column(type_Int, "tenant");
+    table.add_column(type_String, "status", true);
+    table.add_column(type_Timestamp, "created", true);
+    table.add_column(type_Int, "amount", true);
+    table.add_column(type_Bool, "flag");
+    const char* statuses[] = {"open", "closed", "", "open\0ed", "pending"};
+    auto fill = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            table.set_int(0, i, int64_t(i % 7) - 3);
+            if (i % 19 == 0)
+                table.set_string(1, i, realm::null());
+            else
+                table.set_string(1, i, StringData(statuses[i % 5], i % 5 == 3 ? 7 : strlen(statuses[i % 5])));
+            if (i % 23 == 0)
+                table.set_null(2, i);
+            else {
+                int64_t seconds = int64_t((i * 7919) % 1000) - 500;
+                table.set_timestamp(2, i, Timestamp(seconds, seconds < 0 ? -int32_t(i % 2) : int32_t(i % 2)));
+            }
+            if (i % 29 == 0)
+                table.set_null(3, i);
+            else
+                table.set_int(3, i, int64_t((i * 31) % 200) - 100);
+            table.set_bool(4, i, i % 3 == 0);
+        }
+    };
+    table.add_empty_row(3000);
+    fill(0, 3000);
+
+    // Column numbers are passed in so that the same queries can run after columns have moved
+    auto run_all = [&](size_t tenant, size_t status, size_t created, size_t amount, size_t flag) {
+        std::vector<size_t> results;
+        for (int64_t t : {-3, 0, 3, 4}) {
+            for (const char* st : {"open", "closed", ""}) {
+                Timestamp ts(t * 50, 0);
+                results.push_back(table.where().equal(tenant, t).equal(status, st).greater(created, ts).count());
+                results.push_back(
+                    table.where().equal(status, st).less_equal(created, ts).equal(tenant, t).count(100, 2000));
+                results.push_back(table.where()
+                                      .equal(tenant, t)
+                                      .equal(status, st)
+                                      .greater_equal(created, ts)
+                                      .less(created, Timestamp(t * 50 + 200, 1))
+                                      .count());
+                results.push_back(table.where().equal(tenant, t).equal(status, st).find(1500));
+                results.push_back(size_t(table.where().equal(tenant, t).equal(status, st).sum_int(amount)));
+                results.push_back(table.where().equal(tenant, t).greater(created, ts).count());
+                results.push_back(table.where().equal(status, st).greater(created, ts).count());
+                results.push_back(table.where().equal(tenant, t).equal(status, st).equal(flag, true).count());
+                results.push_back(table.where().equal(tenant, t).equal(status, st).Not().less(amount, 0).count());
+                TableView tv = table.where().equal(tenant, t).less(amount, 50).equal(status, st).find_all();
+                for (size_t i = 0; i < tv.size(); ++i)
+                    results.push_back(tv.get_source_ndx(i));
+            }
+            results.push_back(table.where().equal(tenant, t).count());
+            results.push_back(table.where().equal(tenant, t).equal(status, realm::null()).count());
+            results.push_back(table.where().between(tenant, t, t + 2).count());
+        }
+        return results;
+    };
+
+    std::vector<size_t> expected = run_all(0, 1, 2, 3, 4);
+    table.add_composite_index({0, 1, 2});
+    table.add_composite_index({4, 0});
+    table.add_composite_index({3});
+    table.add_composite_index({0, 1, 2});
+    CHECK(table.has_composite_index({0, 1, 2}));
+    CHECK(table.has_composite_index({4, 0}));
+    CHECK(!table.has_composite_index({0, 1}));
+    CHECK(run_all(0, 1, 2, 3, 4) == expected);
+
+    // The index is rebuilt after the table changes
+    table.insert_empty_row(3, 500);
+    fill(0, 3500);
+    table.set_int(0, 0, 100);
+    table.move_last_over(10);
+    table.swap_rows(20, 30);
+    table.remove(40);
+    std::vector<size_t> after_change = run_all(0, 1, 2, 3, 4);
+    table.remove_composite_index({0, 1, 2});
+    CHECK(!table.has_composite_index({0, 1, 2}));
+    CHECK(run_all(0, 1, 2, 3, 4) == after_change);
+    table.add_composite_index({0, 1, 2});
+
+    // Indexes follow their columns around, and are dropped with them
+    table.insert_column(0, type_String, "new");
+    CHECK(table.has_composite_index({1, 2, 3}));
+    CHECK(table.has_composite_index({5, 1}));
+    CHECK(run_all(1, 2, 3, 4, 5) == after_change);
+    table.remove_column(0);
+    _impl::TableFriend::move_column(*table.get_descriptor(), 4, 0);
+    CHECK(table.has_composite_index({1, 2, 3}));
+    CHECK(table.has_composite_index({0, 1}));
+    CHECK(run_all(1, 2, 3, 4, 0) == after_change);
+    table.remove_column(3);
+    CHECK(!table.has_composite_index({1, 2, 3}));
+    CHECK(table.has_composite_index({0, 1}));
+    CHECK(table.has_composite_index({3}));
+
+    CHECK_LOGIC_ERROR(table.add_composite_index({}), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_composite_index({1, 1}), LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table.add_composite_index({1, 4}), LogicError::column_index_out_of_range);
+    table.add_column(type_Double, "double");
+    CHECK_LOGIC_ERROR(table.add_composite_index({4}), LogicError::illegal_combination);
+}
+
+
 #endif // TEST_QUERY
@@ -19,6 +19,7 @@
 #include "testsettings.hpp"
 #ifdef TEST_STRING_DATA
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <sstream>
@@ -494,4 +495,58 @@ TEST(StringData_STL_Stream)
     CHECK_EQUAL(s, out.str());
 }
 
+TEST(StringData_Find)
+{
+    // Cover needles found at every offset relative to the 16-byte blocks of
+    // the vectorized search, and at both ends of the haystack
+    std::string haystack;
+    for (int i = 0; i < 70; ++i)
+        haystack += char('a' + i % 26);
+    StringData h(haystack);
+
+    for (size_t n = 1; n <= 20; ++n) {
+        for (size_t i = 0; i + n <= haystack.size(); ++i) {
+            StringData needle = h.substr(i, n);
+            CHECK_EQUAL(h.find(needle), haystack.find(std::string(needle)));
+        }
+    }
+
+    CHECK_EQUAL(h.find(""), 0);
+    CHECK_EQUAL(h.find("ab-"), h.size());
+    CHECK_EQUAL(h.find("zq"), h.size());
+    std::string longer = haystack + "x";
+    CHECK_EQUAL(h.find(longer), h.size());
+    CHECK_EQUAL(StringData("").find("a"), 0);
+    CHECK_EQUAL(StringData(realm::null()).find("a"), 0);
+
+    // First and last byte match, middle does not
+    CHECK_EQUAL(StringData("axxb axb ayb").find("ayb"), 9);
+}
+
+TEST(StringData_SearchCaseFoldAscii)
+{
+    std::string haystack;
+    for (int i = 0; i < 70; ++i)
+        haystack += char(i % 2 ? 'a' + i % 26 : 'A' + i % 26);
+    // Non-ASCII bytes must never match
+    haystack += "\xc3\xa6test";
+    StringData h(haystack);
+
+    for (size_t n = 1; n <= 20; ++n) {
+        for (size_t i = 0; i + n <= haystack.size(); ++i) {
+            std::string needle = haystack.substr(i, n);
+            std::string upper = case_map(needle, true, IgnoreErrors);
+            std::string lower = case_map(needle, false, IgnoreErrors);
+            if (std::any_of(needle.begin(), needle.end(), [](char c) { return (c & 0x80) != 0; }))
+                continue;
+            CHECK_EQUAL(search_case_fold_ascii(h, upper.c_str(), lower.c_str(), n),
+                        search_case_fold(h, upper.c_str(), lower.c_str(), n));
+        }
+    }
+
+    CHECK_EQUAL(search_case_fold_ascii(h, "XZY", "xzy", 3), h.size());
+    CHECK_EQUAL(search_case_fold_ascii(h, "TEST", "test", 4), h.size() - 4);
+}
+
+
 #endif
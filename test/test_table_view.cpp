@@ -24,6 +24,8 @@
 #include <sstream>
 #include <ostream>
 #include <cwchar>
+#include <cstring>
+#include <numeric>
 
 #include <realm/group_shared.hpp>
 #include <realm/table_view.hpp>
@@ -3470,4 +3472,168 @@ TEST(TableView_TimestampMaxRemoveRow)
     CHECK_EQUAL(tv.maximum_timestamp(0), Timestamp(8, 0));
 }
 
+TEST(TableView_SortAndDistinctByRangeIndex)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_Int, "int_null", true);
+    table.add_column(type_Float, "float", true);
+    table.add_column(type_Timestamp, "time", true);
+    table.add_empty_row(200);
+    for (size_t i = 0; i < 200; ++i) {
+        int64_t value = int64_t((i * 7919) % 37) - 18;
+        table.set_int(0, i, value);
+        if (i % 11 == 0) {
+            table.set_null(1, i);
+            table.set_null(2, i);
+            table.set_null(3, i);
+        }
+        else {
+            table.set_int(1, i, value);
+            table.set_float(2, i, value == 0 && i % 2 ? -0.f : float(value) / 2);
+            table.set_timestamp(3, i, Timestamp(value, 0));
+        }
+    }
+
+    auto get_rows = [](const TableView& tv) {
+        std::vector<size_t> rows;
+        for (size_t i = 0; i < tv.size(); ++i)
+            rows.push_back(tv.get_source_ndx(i));
+        return rows;
+    };
+    auto get_results = [&](size_t col) {
+        std::vector<std::vector<size_t>> results;
+        for (bool ascending : {true, false}) {
+            TableView tv = table.get_sorted_view(col, ascending);
+            results.push_back(get_rows(tv));
+            tv.distinct(DistinctDescriptor(table, {{col}}));
+            results.push_back(get_rows(tv));
+
+            // Views whose rows are not in table order
+            tv = table.where().not_equal(0, 1).find_all();
+            tv.sort(0, false);
+            tv.distinct(DistinctDescriptor(table, {{col}}));
+            results.push_back(get_rows(tv));
+            tv = table.where().not_equal(0, 1).find_all();
+            tv.distinct(DistinctDescriptor(table, {{0}, {1}}));
+            tv.sort(col, ascending);
+            results.push_back(get_rows(tv));
+        }
+        return results;
+    };
+
+    for (size_t col = 0; col < table.get_column_count(); ++col) {
+        auto expected = get_results(col);
+        table.add_range_index(col);
+        CHECK(get_results(col) == expected);
+
+        // The index must follow changes to the table
+        table.set_int(0, 5, 100);
+        table.remove(7);
+        table.remove_range_index(col);
+        expected = get_results(col);
+        table.add_range_index(col);
+        CHECK(get_results(col) == expected);
+        table.remove_range_index(col);
+    }
+}
+
+TEST(TableView_SortByKeys)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_Int, "int_null", true);
+    table.add_column(type_Double, "double", true);
+    table.add_column(type_Timestamp, "time", true);
+    table.add_column(type_String, "string", true);
+    const char* strings[] = {"", "a", "A", "ab", "abcdefgh", "abcdefghi", "abcdefghj", "abcdefgh\0", "\xc3\xa9",
+                             "e", "f", "\xe4\xb8\xad"};
+    table.add_empty_row(300);
+    for (size_t i = 0; i < 300; ++i) {
+        int64_t value = int64_t((i * 7919) % 13) - 6;
+        table.set_int(0, i, value * 1000000007);
+        if (i % 7 == 0) {
+            table.set_null(1, i);
+            table.set_null(2, i);
+            table.set_null(3, i);
+            table.set_null(4, i);
+            continue;
+        }
+        table.set_int(1, i, int64_t(i % 5) - 2);
+        table.set_double(2, i, value == 0 && i % 2 ? -0.0 : value / 3.0);
+        table.set_timestamp(3, i, Timestamp(value % 3, value < 0 ? -int32_t(i % 2) : int32_t(i % 2)));
+        size_t n = (i * 31) % 12;
+        table.set_string(4, i, StringData(strings[n], n == 7 ? 9 : std::strlen(strings[n])));
+    }
+
+    auto compare = [&](size_t col, size_t a, size_t b) {
+        bool null_a = table.is_null(col, a), null_b = table.is_null(col, b);
+        if (null_a || null_b)
+            return null_a == null_b ? 0 : null_a ? -1 : 1;
+        switch (table.get_column_type(col)) {
+            case type_Int: {
+                int64_t x = table.get_int(col, a), y = table.get_int(col, b);
+                return x == y ? 0 : x < y ? -1 : 1;
+            }
+            case type_Double: {
+                double x = table.get_double(col, a), y = table.get_double(col, b);
+                return x == y ? 0 : x < y ? -1 : 1;
+            }
+            case type_Timestamp: {
+                Timestamp x = table.get_timestamp(col, a), y = table.get_timestamp(col, b);
+                return x == y ? 0 : x < y ? -1 : 1;
+            }
+            default: {
+                StringData x = table.get_string(col, a), y = table.get_string(col, b);
+                return x == y ? 0 : utf8_compare(x, y) ? -1 : 1;
+            }
+        }
+    };
+
+    auto check = [&](std::vector<std::vector<size_t>> columns, std::vector<bool> ascending) {
+        std::vector<size_t> expected(table.size());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) {
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (int c = compare(columns[i][0], a, b))
+                    return ascending[i] ? c < 0 : c > 0;
+            }
+            return false;
+        });
+        TableView tv = table.get_sorted_view(SortDescriptor(table, columns, ascending));
+        CHECK_EQUAL(tv.size(), expected.size());
+        bool equal = true;
+        for (size_t i = 0; i < tv.size(); ++i)
+            equal = equal && tv.get_source_ndx(i) == expected[i];
+        CHECK(equal);
+    };
+
+    for (int pass = 0; pass < 2; ++pass) {
+        check({{0}}, {false});
+        check({{4}}, {true});
+        check({{4}, {0}}, {false, true});
+        check({{1}, {2}, {3}}, {true, false, true});
+        check({{3}, {4}, {1}}, {false, true, false});
+        check({{2}, {4}}, {true, true});
+
+        // Distinct sorts by keys as well
+        TableView tv = table.where().find_all();
+        tv.distinct(DistinctDescriptor(table, {{1}, {4}}));
+        std::vector<std::pair<util::Optional<int64_t>, std::string>> seen;
+        for (size_t i = 0; i < tv.size(); ++i) {
+            std::pair<util::Optional<int64_t>, std::string> value;
+            if (!tv.is_null(1, i))
+                value.first = tv.get_int(1, i);
+            StringData str = tv.get_string(4, i);
+            value.second = str.is_null() ? "null" : std::string(str) + "!";
+            CHECK(std::find(seen.begin(), seen.end(), value) == seen.end());
+            seen.push_back(value);
+        }
+        CHECK_EQUAL(seen.size(), 5 * 12 + 1);
+
+        // Enumerated strings
+        table.optimize(true);
+    }
+}
+
 #endif // TEST_TABLE_VIEW